@@ -0,0 +1,75 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Role.hpp"
+
+namespace coup {
+
+class Game;
+class Player;
+
+// Every action a player can take on his turn (generic actions first, then role specials)
+enum class ActionId : std::uint8_t {
+    Gather,
+    Tax,
+    Bribe,
+    Arrest,
+    Sanction,
+    Coup,
+    Invest,
+    BlockTax,
+    BlockArrest,
+    BlockCoup,
+    BlockBribe,
+    Count // Number of actions (not an action)
+};
+
+constexpr std::size_t ACTION_COUNT = static_cast<std::size_t>(ActionId::Count);
+
+// Outcome of an action - every reason a move can be illegal (cheap to return, no message is built)
+enum class ActionResult : std::uint8_t {
+    Ok,
+    InactivePlayer, // The player is out of the game
+    NotYourTurn, // It's another player's turn
+    Sanctioned, // Sanctioned players can't Tax or Gather
+    TaxBlocked, // Tax was blocked by a Governor
+    ArrestBlocked, // Arrest was blocked by a Spy
+    BribeBlocked, // Bribe was blocked by a Judge
+    AlreadyBribed, // Only one bribe per turn
+    MustCoup, // With 10 coins or more the only allowed action is Coup
+    NotEnoughCoins, // The player can't pay for the action
+    TargetNotEnoughCoins, // The target has no coins to lose (arrest)
+    SelfTarget, // The action can't target the player himself
+    TargetEliminated, // The target is out of the game
+    RecentlyArrested, // The target was the last one arrested
+    AlreadyOnCoupTrial, // The target is already on coup trial
+    NotOnCoupTrial, // There is no coup to block on the target
+    WrongRole, // The action belongs to another role
+    MissingTarget, // The action needs a target and got none
+    UnexpectedTarget, // The action does not take a target
+    UnknownAction, // The action name is not in the action table
+};
+
+// Handler that performs the action (returns why an illegal move was refused - nothing changes then).
+// The game reports the event and advances the turn afterwards.
+using ActionHandler = ActionResult (*)(Game& game, Player& player, Player* target);
+
+// One row of the action table - how the engine runs an action (costs, roles and blockers are rules: Game::rules())
+struct ActionDescriptor {
+    const char* name; // Name shown in the GUI / CLI
+    bool needsTarget; // Does the action require a target player
+    bool endsTurn; // Does the turn pass to the next player afterwards (Bribe gives another action)
+    ActionHandler handler; // Function that executes the action
+};
+
+const ActionDescriptor& describe(ActionId action); // Returns the table row of an action (O(1))
+const char* actionName(ActionId action); // Returns the display name of an action
+bool parseAction(const std::string& name, ActionId& action); // Converts a name into an action id (GUI / CLI boundary only)
+
+// Builds the text of a result (only when someone needs to show it)
+std::string resultMessage(ActionResult result, ActionId action, const Player& player, const Player* target = nullptr);
+
+}
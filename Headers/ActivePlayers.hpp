@@ -0,0 +1,62 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "GameState.hpp"
+
+namespace coup {
+
+class Player;
+
+// The players still in the game, in seat order (see Game::activePlayers). A view over the table - it never
+// allocates and always shows the current table, so a player eliminated while iterating is skipped from then on.
+class ActivePlayers {
+public:
+    // Forward iterator over the active seats
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Player*;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Player* const*;
+        using reference = Player*;
+
+        iterator() = default;
+        iterator(Player* const* players, const GameState* table, Seat seat) noexcept
+            : players(players), table(table), seat(seat) {
+            if (seat < table->seat_count && !hasSeat(table->active_seats, seat)) advance();
+        }
+
+        reference operator*() const noexcept { return players[seat]; }
+        iterator& operator++() noexcept { advance(); return *this; }
+        iterator operator++(int) noexcept { iterator before = *this; ++*this; return before; }
+        bool operator==(const iterator& other) const noexcept { return seat == other.seat; }
+        bool operator!=(const iterator& other) const noexcept { return seat != other.seat; }
+
+    private:
+        Player* const* players = nullptr; // Player objects of the game, indexed by seat
+        const GameState* table = nullptr; // Table the active seats are read from
+        Seat seat = 0; // Current seat (table->seat_count when done)
+
+        // Moves to the next active seat after this one (no wrap around)
+        void advance() noexcept {
+            const Seat after = seatAfter(table->active_seats, seat);
+            seat = after != NO_SEAT ? after : table->seat_count;
+        }
+    };
+
+    ActivePlayers(Player* const* players, const GameState* table) noexcept : players(players), table(table) {}
+
+    iterator begin() const noexcept { return iterator(players, table, 0); }
+    iterator end() const noexcept { return iterator(players, table, table->seat_count); }
+    std::size_t size() const noexcept { return seatCount(table->active_seats); } // O(1) - see seatCount
+    bool empty() const noexcept { return seatCount(table->active_seats) == 0; }
+
+private:
+    Player* const* players; // Player objects of the game, indexed by seat
+    const GameState* table; // Table of the game
+};
+
+}
@@ -8,8 +8,7 @@ namespace coup {
 class Baron : public Player {
 public:
     Baron(Game& game, const std::string& name);
-    void invest(); // custom ability
-    std::string role() const override; // Return player's role
+    void invest(); // custom ability (tryInvest is shared by every player and refuses other roles)
 };
 
 }
\ No newline at end of file
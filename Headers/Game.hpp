@@ -5,44 +5,159 @@
 #include <string>
 #include <stdexcept>
 #include "../Headers/Player.hpp"
-#include <random>
+#include "../Headers/PlayerSlot.hpp"
+#include "../Headers/ActivePlayers.hpp"
+#include "../Headers/Action.hpp"
+#include "../Headers/GameState.hpp"
+#include "../Headers/UndoJournal.hpp"
+#include "../Headers/Zobrist.hpp"
+#include "../Headers/MoveList.hpp"
+#include "../Headers/Rng.hpp"
+#include "../Headers/GameEvent.hpp"
+#include "../Headers/Replay.hpp"
+#include "../Headers/RuleTable.hpp"
 
 namespace coup {
 
 class Game {
+    friend class Player; // Players read and write their seat in the game state
+
 private:
     
-    std::vector<Player*> player_list;
-    size_t current_turn = 0;
-    bool didPayBribe = false;
+    PlayerSlot player_slots[MAX_PLAYERS]; // Storage the players are built in - a game allocates nothing for its players
+    Player* player_list[MAX_PLAYERS] = {}; // Player objects, indexed by seat (the first table.seat_count are taken)
+    GameState table; // Coins, flags, turn and bribe/arrest bookkeeping of every seat
+    UndoJournal journal; // Changes of the recorded actions (only when undo is enabled)
+    EventLog event_log; // Typed events of the entry points (only collected when enabled)
+    ReplayWriter* recorder = nullptr; // Replay that receives every state-changing call (nullptr if not recording)
+    Rng generator; // Random generator of this table (roles, bots, simulations) - never shared with another game
+    const RuleTable* rule_table = nullptr; // Rules file the table plays by (shared, never owned) - nullptr: a compiled variant
+    std::uint8_t rule_variant = 0; // Compiled rules variant the table plays by when it has no rules file (0: Rules)
 
-    
+    void seatPlayer(RoleId role, const std::string& name); // Builds a player in the next free seat
+    void destroyPlayers() noexcept; // Destroys every player in place and frees the seats
+    void takePlayers(Game& other) noexcept; // Rebuilds the players of another game in this one (move)
+
+    // Every change to the table goes through these, so it can be recorded for undo
+    void changeCoins(Seat seat, int delta);
+    void setFlags(Seat seat, std::uint8_t mask);
+    void clearFlags(Seat seat, std::uint8_t mask);
+    void setTurn(Seat seat);
+    void setBribe(bool paid);
+    void setLastArrested(Seat seat);
+    void setLastTurn(Seat seat);
+    void verifyHash() const; // Debug builds check the incremental hash against a full recompute
+    void eliminateOnTrial(Player* player); // Eliminates a player whose coup trial was not blocked and reports it
+    void endTurnOf(Player* last_turn_player); // Moves the turn on from the player who held it (never re-enters turn())
+    void record(StepKind kind, ActionId action, const Player* actor, const Player* target = nullptr); // Appends a step to the replay (if recording)
+
+    // Runs `body` with the rules view the table plays by - the PolicyRules of its variant, whose lookups fold into
+    // constants, unless a rules file was set. The rule-dependent code is written once against the view and compiled
+    // for each variant and for tables.
+    template <typename Body>
+    decltype(auto) withRules(Body&& body) const {
+        if (rule_table) return body(TableRules{rule_table});
+        return withRuleVariant(rule_variant, std::forward<Body>(body));
+    }
+
+    // Legal-move checks shared by legalActions and randomLegalAction
+    template <typename R> bool canUse(const R& rules, ActionId action, Seat seat) const noexcept; // Whether the seat's player may play the action now (on some target, if it takes one)
+    template <typename R> bool canTarget(const R& rules, ActionId action, Seat seat, Seat target) const noexcept; // Whether an action the seat can use may target another seat
+    // Whether the seat's player is forced to coup this turn (10 coins or more by default). Only if he can pay for a Coup
+    // and his role may use one - under rules where he can't, he keeps his normal moves instead of having none.
+    template <typename R>
+    bool mustCoup(const R& rules, Seat seat) const noexcept {
+        const int coins = table.coins[seat];
+        return coins >= rules.forcedCoupCoins() && coins >= rules.cost(ActionId::Coup) && rules.mayUse(table.roles[seat], ActionId::Coup);
+    }
+    template <typename R> MoveList listMoves(const R& rules, const Player* player) const noexcept; // legalActions for one kind of rules
+    template <typename R> Move drawMove(const R& rules, const Player* player, Rng& rng, ActionId only) const noexcept; // randomLegalAction for one kind
+
+    // String-log entry points collect the events of one call and render them as text
+    std::size_t beginText(bool& wasEnabled);
+    void endText(std::size_t mark, bool wasEnabled, std::vector<std::string>& log);
 
 public:
-    Game();
+    Game(); // Same as Game(0) - seed explicitly (e.g. from std::random_device) for a different game every run
+    explicit Game(std::uint64_t seed); // Table whose random choices all come from this seed (replayable)
     ~Game();
+    Game(const Game& other); // Deep copy - every player is recreated and bound to the new game
+    Game& operator=(const Game& other);
+    Game(Game&& other) noexcept; // Move - players live in the game's own slots, so each one is rebuilt in the new game (no allocation, ~20 ns a seat)
+    Game& operator=(Game&& other) noexcept;
+
+    Game clone() const; // Returns an independent deep copy of the table (for lookahead)
+
+    Rng& random(); // Returns the random generator of the table (clones continue the same stream)
+    std::uint64_t seed() const; // Returns the seed the table was created with
+
+    // Rules: a game plays by the built-in Rules (compile-time constants) until it gets a rule table. The table of a
+    // compiled variant (variantRules) switches to that variant's constants. A copy or clone keeps the rules of its
+    // original. Replays store a fingerprint of them - replay with the same table (gameFromReplay checks it).
+    void setRules(const RuleTable& rules); // Plays by a rule table from now on (it must outlive the game - load it once at startup)
+    const RuleTable& rules() const; // Returns the rules the game plays by as a table (defaultRules() for the built-in ones)
+
+    const GameState& state() const; // Returns the packed state of the table (cheap to copy)
+    std::uint64_t hash() const; // Returns the Zobrist hash of the table (equal states have equal hashes)
+    void loadState(const GameState& state); // Restores a state taken from this table (same seats and roles)
+
+    // Make / unmake: every action (and every turn change it causes) becomes one entry that undo() reverts exactly
+    void enableUndo(bool enabled = true); // Starts / stops recording actions (clears the journal)
+    bool undo(); // Reverts the last recorded action (false if there is nothing to undo)
+    std::size_t undoDepth() const; // Number of recorded actions that can be undone
+
     std::vector<Player*> getPlayers() const; // Returns vector of the current players in the game (in Player objects)
+    ActivePlayers activePlayers() const; // Same players as a view over the table (no allocation, always current)
+    std::size_t activeCount() const; // Returns the number of players still in the game (O(1))
+    Player* playerAt(std::size_t seat) const; // Returns the player sitting at a seat (also eliminated ones)
     Player* turn(); // Returns the player whose turn it is
+    MoveList legalActions(const Player* player) const noexcept; // Returns every move the rules allow the player right now (empty if it's not his turn)
+    // Returns a uniformly random legal move of the player (action ActionId::Count if he has none) without listing them all,
+    // optionally among the moves of one action only - what simulations and rollouts play on large tables
+    Move randomLegalAction(const Player* player, Rng& rng, ActionId only = ActionId::Count) const noexcept;
 
-    // Two general functions that know how to handle a turn with each action
-    void handleTurnWithTarget(Player* player, const std::string& action, Player* target, std::vector<std::string>& log); 
-    void handleTurnWithNoTarget(Player* player, const std::string& action, std::vector<std::string>& log);
+    // Events: every entry point below reports what happened as a GameEvent (collected only while enabled, see renderEvent)
+    EventLog& events(); // Returns the event buffer of the table
+    const EventLog& events() const;
+
+    // Two general functions that know how to handle a turn with each action (dispatched through the action table).
+    // They never throw on an illegal move - the result says why it was refused
+    ActionResult handleTurnWithTarget(Player* player, ActionId action, Player* target);
+    ActionResult handleTurnWithNoTarget(Player* player, ActionId action);
 
     // Special function that handles block consequences logic when its not the blocker's turn
-    bool handleBlockConsequences(const std::string& action, Player* blocker, Player* initiator, std::vector<std::string>& log);
+    bool handleBlockConsequences(ActionId action, Player* blocker, Player* initiator);
 
     // Small simple function to handle Merchant passive ability
+    void handleMerchantPassive(Player* player);
+
+    void checkElimination(); // Function that checks elimination before each player's turn and eliminates if there is a need to
+    void passTurn(); // The current player has no legal move - the turn goes to the next player
+
+    // Replays: every call above that changes the table is appended to the writer as one step (see Replay.hpp).
+    // Clones never record, and undo() does not remove steps.
+    void recordTo(ReplayWriter* writer); // Starts recording into `writer` (nullptr stops)
+
+    // Same entry points with a text log - the events of the call are rendered and appended to `log` (GUI / CLI)
+    ActionResult handleTurnWithTarget(Player* player, ActionId action, Player* target, std::vector<std::string>& log);
+    ActionResult handleTurnWithNoTarget(Player* player, ActionId action, std::vector<std::string>& log);
+    ActionResult handleTurnWithTarget(Player* player, const std::string& action, Player* target, std::vector<std::string>& log); // Parses the action name first
+    ActionResult handleTurnWithNoTarget(Player* player, const std::string& action, std::vector<std::string>& log); // Parses the action name first
+    bool handleBlockConsequences(ActionId action, Player* blocker, Player* initiator, std::vector<std::string>& log);
+    bool handleBlockConsequences(const std::string& action, Player* blocker, Player* initiator, std::vector<std::string>& log);
     void handleMerchantPassive(Player* player, std::vector<std::string>& log);
+    void checkElimination(std::vector<std::string>& log);
+    void passTurn(std::vector<std::string>& log);
 
     std::vector<std::string> players() const; // Returns vector of the current players in the game (in string)
     Player* winner() const; // Function that declares winner
     void addPlayerWithRandomRole(const std::string& name); // Function to add player with random Role
-    void checkElimination(std::vector<std::string>& log); // Function that checks elimination before each player's turn and eliminates if there is a need to
 
     void nextTurn(); // Called manually after a player's action - changes turns
 
     
-    void addPlayerWithRole(const std::string& name, const std::string& role); // Function that adds player with desired role (only used for testing)
+    void addPlayerWithRole(const std::string& name, RoleId role); // Function that adds player with desired role
+    void addPlayerWithRole(const std::string& name, const std::string& role); // Same as above, parses the role name first (only used for testing)
     
 };
 
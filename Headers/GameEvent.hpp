@@ -0,0 +1,69 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Action.hpp"
+#include "GameState.hpp"
+
+namespace coup {
+
+class Game;
+
+// What happened (the text of an event is only built when a consumer asks for it)
+enum class EventKind : std::uint8_t {
+    ActionPlayed, // actor played action (on target)
+    ActionFailed, // actor tried action (on target) and the rules refused it with result
+    ActionRejected, // the turn was refused before reaching the rules (missing, eliminated or unexpected players)
+    BlockPaid, // actor blocked target's action and the block's costs were paid
+    BlockUnpaid, // actor tried to block target's action but the coins were missing (result: NotEnoughCoins if the actor's,
+                 // TargetNotEnoughCoins if the target's)
+    MerchantPassive, // actor got the passive coins of his role (the Merchant's by default)
+    Eliminated, // actor was eliminated by an unresolved coup
+    Pass, // actor had no legal move and passed the turn
+};
+
+// One compact engine event (12 bytes, no strings)
+struct GameEvent {
+    EventKind kind;
+    ActionId action; // Action the event is about (ActionId::Count if none)
+    ActionResult result; // Outcome code (ActionResult::Ok unless the action failed)
+    Seat actor; // Seat that acted (NO_SEAT if unknown)
+    Seat target; // Seat that was targeted (NO_SEAT if none)
+    std::int16_t actorCoins; // Coins the actor gained (negative if paid)
+    std::int16_t targetCoins; // Coins the target gained (negative if lost)
+};
+
+// Reusable buffer of events. Off by default - then emitting an event is a single branch.
+class EventLog {
+public:
+    void setEnabled(bool on) { enabled = on; } // Starts / stops collecting events
+    bool isEnabled() const { return enabled; } // Returns whether events are collected
+
+    // Adds an event (does nothing while disabled)
+    void push(EventKind kind, ActionId action, ActionResult result, Seat actor, Seat target = NO_SEAT,
+              int actorCoins = 0, int targetCoins = 0) {
+        if (!enabled) return;
+        events.push_back(GameEvent{kind, action, result, actor, target,
+                                   static_cast<std::int16_t>(actorCoins), static_cast<std::int16_t>(targetCoins)});
+    }
+
+    void clear() { events.clear(); } // Drops every event (the buffer keeps its capacity)
+    void truncate(std::size_t count) { if (count < events.size()) events.resize(count); } // Drops the events after the first `count`
+
+    std::size_t size() const { return events.size(); }
+    bool empty() const { return events.empty(); }
+    const GameEvent& operator[](std::size_t i) const { return events[i]; }
+    std::vector<GameEvent>::const_iterator begin() const { return events.begin(); }
+    std::vector<GameEvent>::const_iterator end() const { return events.end(); }
+
+private:
+    std::vector<GameEvent> events; // Collected events, oldest first
+    bool enabled = false; // Whether events are collected
+};
+
+std::string renderEvent(const Game& game, const GameEvent& event); // Builds the log line of an event (GUI log panel, demo printer)
+
+}
@@ -0,0 +1,249 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "Role.hpp"
+
+namespace coup {
+
+// Number of seats at a table. Build with -DCOUP_MAX_SEATS=N (up to 4096) for large tables - every per-turn
+// operation stays O(1), only the per-table arrays grow (see "Large tables" in the README).
+#ifndef COUP_MAX_SEATS
+#define COUP_MAX_SEATS 6
+#endif
+constexpr std::size_t MAX_PLAYERS = COUP_MAX_SEATS;
+static_assert(MAX_PLAYERS >= 2 && MAX_PLAYERS <= 4096, "COUP_MAX_SEATS must be between 2 and 4096");
+
+// Index of a seat (one byte unless the table is large)
+using Seat = std::conditional_t<(MAX_PLAYERS < 0xFF), std::uint8_t, std::uint16_t>;
+constexpr Seat NO_SEAT = static_cast<Seat>(-1); // Marks an empty seat index (e.g. nobody was arrested yet)
+
+// Bits of the per-seat flag mask
+enum PlayerFlag : std::uint8_t {
+    FLAG_SANCTIONED = 1 << 0, // The player can't preform tax & gather actions for his next turn
+    FLAG_TAX_BLOCKED = 1 << 1, // The player can't preform tax action for his next turn
+    FLAG_ARREST_BLOCKED = 1 << 2, // The player can't preform arrest action for his next turn
+    FLAG_BRIBE_BLOCKED = 1 << 3, // The player can't preform bribe action for his next turn
+    FLAG_COUP_TRIAL = 1 << 4, // The player was tagged for a coup, only the general can undo this. On his next turn he will be terminated
+    FLAG_ACTIVE = 1 << 5, // The player is in/out of the game
+};
+
+// Number of set bits of a word. Bit arithmetic instead of __builtin_popcount, which is a library call
+// unless the build targets a CPU with a popcount instruction (-mpopcnt)
+inline unsigned bitCount(std::uint64_t word) {
+    word -= (word >> 1) & 0x5555555555555555ull;
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<unsigned>((word * 0x0101010101010101ull) >> 56);
+}
+
+// Set of seats, one bit per seat (seat 0 is the lowest bit). The same free functions work on both layouts.
+#if COUP_MAX_SEATS <= 8
+using SeatMask = std::uint8_t;
+
+// Whether a seat is in the set
+inline bool hasSeat(SeatMask mask, Seat seat) {
+    return (mask >> seat) & 1u;
+}
+
+inline void addSeat(SeatMask& mask, Seat seat) {
+    mask = static_cast<SeatMask>(mask | (1u << seat));
+}
+
+inline void removeSeat(SeatMask& mask, Seat seat) {
+    mask = static_cast<SeatMask>(mask & ~(1u << seat));
+}
+
+inline void toggleSeat(SeatMask& mask, Seat seat) {
+    mask = static_cast<SeatMask>(mask ^ (1u << seat));
+}
+
+// Number of seats in a mask
+inline unsigned seatCount(SeatMask mask) {
+    return bitCount(mask);
+}
+
+// Lowest seat of a mask (NO_SEAT if empty)
+inline Seat firstSeat(SeatMask mask) {
+    return mask ? static_cast<Seat>(__builtin_ctz(mask)) : NO_SEAT;
+}
+
+// Lowest seat of a mask above `seat` (NO_SEAT if none)
+inline Seat seatAfter(SeatMask mask, Seat seat) {
+    return firstSeat(static_cast<SeatMask>(mask & ~((2u << seat) - 1)));
+}
+
+// The n-th lowest seat of a mask, counting from 0 (NO_SEAT if the mask has fewer seats)
+inline Seat nthSeat(SeatMask mask, unsigned n) {
+    while (n-- && mask) mask = static_cast<SeatMask>(mask & (mask - 1));
+    return firstSeat(mask);
+}
+
+// Seats in both masks
+inline SeatMask commonSeats(SeatMask a, SeatMask b) {
+    return static_cast<SeatMask>(a & b);
+}
+
+// Seats of `a` that are not in `b`
+inline SeatMask seatsWithout(SeatMask a, SeatMask b) {
+    return static_cast<SeatMask>(a & ~b);
+}
+#else
+constexpr std::size_t SEAT_WORDS = (MAX_PLAYERS + 63) / 64;
+
+// Large tables: a bit per seat in 64-bit words, plus a summary bit per non-empty word and the seat count,
+// so finding the next seat is two count-trailing-zeros and the count is a field - no scan over the table
+struct SeatMask {
+    std::uint64_t words[SEAT_WORDS] = {}; // Bit (seat % 64) of word (seat / 64)
+    std::uint64_t summary = 0; // Bit w is set while words[w] is not empty
+    std::uint16_t count = 0; // Number of seats in the set
+};
+
+inline bool operator==(const SeatMask& a, const SeatMask& b) {
+    return a.count == b.count && a.summary == b.summary && std::memcmp(a.words, b.words, sizeof(a.words)) == 0;
+}
+
+// Whether a seat is in the set
+inline bool hasSeat(const SeatMask& mask, Seat seat) {
+    return (mask.words[seat >> 6] >> (seat & 63)) & 1u;
+}
+
+inline void toggleSeat(SeatMask& mask, Seat seat) {
+    std::uint64_t& word = mask.words[seat >> 6];
+    const std::uint64_t bit = std::uint64_t{1} << (seat & 63);
+    word ^= bit;
+    if (word & bit) ++mask.count;
+    else --mask.count;
+    if (word) mask.summary |= std::uint64_t{1} << (seat >> 6);
+    else mask.summary &= ~(std::uint64_t{1} << (seat >> 6));
+}
+
+inline void addSeat(SeatMask& mask, Seat seat) {
+    if (!hasSeat(mask, seat)) toggleSeat(mask, seat);
+}
+
+inline void removeSeat(SeatMask& mask, Seat seat) {
+    if (hasSeat(mask, seat)) toggleSeat(mask, seat);
+}
+
+// Number of seats in a mask
+inline unsigned seatCount(const SeatMask& mask) {
+    return mask.count;
+}
+
+// Lowest seat of a mask (NO_SEAT if empty)
+inline Seat firstSeat(const SeatMask& mask) {
+    if (!mask.summary) return NO_SEAT;
+    const unsigned w = static_cast<unsigned>(__builtin_ctzll(mask.summary));
+    return static_cast<Seat>(w * 64 + static_cast<unsigned>(__builtin_ctzll(mask.words[w])));
+}
+
+// Lowest seat of a mask above `seat` (NO_SEAT if none)
+inline Seat seatAfter(const SeatMask& mask, Seat seat) {
+    const unsigned w = seat >> 6, b = seat & 63;
+    const std::uint64_t rest = b == 63 ? 0 : mask.words[w] & (~std::uint64_t{0} << (b + 1)); // Same word, above the seat
+    if (rest) return static_cast<Seat>(w * 64 + static_cast<unsigned>(__builtin_ctzll(rest)));
+    const std::uint64_t later = w == 63 ? 0 : mask.summary & (~std::uint64_t{0} << (w + 1)); // Later non-empty words
+    if (!later) return NO_SEAT;
+    const unsigned next = static_cast<unsigned>(__builtin_ctzll(later));
+    return static_cast<Seat>(next * 64 + static_cast<unsigned>(__builtin_ctzll(mask.words[next])));
+}
+
+// The n-th lowest seat of a mask, counting from 0 (NO_SEAT if the mask has fewer seats) - one bit count per non-empty word
+inline Seat nthSeat(const SeatMask& mask, unsigned n) {
+    for (std::uint64_t left = mask.summary; left; left &= left - 1) {
+        const unsigned w = static_cast<unsigned>(__builtin_ctzll(left));
+        std::uint64_t word = mask.words[w];
+        const unsigned inWord = bitCount(word);
+        if (n >= inWord) {
+            n -= inWord;
+            continue;
+        }
+        while (n--) word &= word - 1;
+        return static_cast<Seat>(w * 64 + static_cast<unsigned>(__builtin_ctzll(word)));
+    }
+    return NO_SEAT;
+}
+
+// Builds a mask word by word from the non-empty words of `a` (the summary and count follow the words)
+template <typename WordOp>
+inline SeatMask combineSeats(const SeatMask& a, WordOp op) {
+    SeatMask result;
+    for (std::uint64_t left = a.summary; left; left &= left - 1) {
+        const unsigned w = static_cast<unsigned>(__builtin_ctzll(left));
+        result.words[w] = op(w);
+        if (!result.words[w]) continue;
+        result.summary |= std::uint64_t{1} << w;
+        result.count = static_cast<std::uint16_t>(result.count + bitCount(result.words[w]));
+    }
+    return result;
+}
+
+// Seats in both masks
+inline SeatMask commonSeats(const SeatMask& a, const SeatMask& b) {
+    return combineSeats(a, [&](unsigned w) { return a.words[w] & b.words[w]; });
+}
+
+// Seats of `a` that are not in `b`
+inline SeatMask seatsWithout(const SeatMask& a, const SeatMask& b) {
+    return combineSeats(a, [&](unsigned w) { return a.words[w] & ~b.words[w]; });
+}
+#endif
+
+// First seat of a mask after `seat`, wrapping around to the lowest seat (`seat` itself comes last; NO_SEAT if empty)
+inline Seat nextSeat(const SeatMask& mask, Seat seat) {
+    const Seat after = seatAfter(mask, seat);
+    return after != NO_SEAT ? after : firstSeat(mask);
+}
+
+// Flags that only last for one turn (cleared after the player's turn)
+constexpr std::uint8_t TURN_FLAGS = FLAG_SANCTIONED | FLAG_TAX_BLOCKED | FLAG_ARREST_BLOCKED | FLAG_BRIBE_BLOCKED;
+
+// The whole state of a table as one plain value (structure of arrays, indexed by seat).
+// Game and Player are views over it, so copying a table for a rollout is a memcpy.
+struct GameState {
+    std::int16_t coins[MAX_PLAYERS] = {}; // Coins of each seat
+    std::uint8_t flags[MAX_PLAYERS] = {}; // PlayerFlag mask of each seat
+    RoleId roles[MAX_PLAYERS] = {}; // Role of each seat
+    Seat seat_count = 0; // Number of seats taken
+    Seat current_turn = 0; // Seat whose turn it is
+    std::uint8_t did_pay_bribe = 0; // 1 when the current player paid a bribe and gets another action this turn
+    Seat last_arrested = NO_SEAT; // Seat that was arrested most recently (arrest cooldown), NO_SEAT if none
+    Seat last_turn = NO_SEAT; // Seat that played the last turn, NO_SEAT if none
+    SeatMask active_seats{}; // Bit per seat with FLAG_ACTIVE (follows the flags, not hashed)
+    SeatMask trial_seats{}; // Bit per seat with FLAG_COUP_TRIAL (follows the flags, not hashed)
+    std::uint64_t hash = 0; // Zobrist hash of the fields above (kept up to date by Game, see Zobrist.hpp)
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must stay a plain value");
+// Two states are equal when every field is equal (the hash follows from the fields)
+inline bool operator==(const GameState& a, const GameState& b) {
+    return std::memcmp(a.coins, b.coins, sizeof(a.coins)) == 0
+        && std::memcmp(a.flags, b.flags, sizeof(a.flags)) == 0
+        && std::memcmp(a.roles, b.roles, sizeof(a.roles)) == 0
+        && a.seat_count == b.seat_count
+        && a.current_turn == b.current_turn
+        && a.did_pay_bribe == b.did_pay_bribe
+        && a.last_arrested == b.last_arrested
+        && a.last_turn == b.last_turn
+        && a.active_seats == b.active_seats
+        && a.trial_seats == b.trial_seats;
+}
+
+inline bool operator!=(const GameState& a, const GameState& b) {
+    return !(a == b);
+}
+
+// Builds the mask of the seats that have a flag (for states whose masks can't be trusted)
+inline SeatMask seatsWith(const GameState& state, std::uint8_t flag) {
+    SeatMask mask{};
+    for (Seat seat = 0; seat < state.seat_count; ++seat) {
+        if (state.flags[seat] & flag) addSeat(mask, seat);
+    }
+    return mask;
+}
+
+}
@@ -7,10 +7,7 @@ namespace coup {
 
 class Governor : public Player {
 public:
-    Governor(Game& game, const std::string& name);
-    void tax() override; // Gets 3 coins instead of 2
-    std::string role() const override; // Return player's role
-    
+    Governor(Game& game, const std::string& name) : Player(game, name, RoleId::Governor) {} // Gets 3 coins from tax (see Player::tryTax)
 };
 
 }
@@ -7,9 +7,7 @@ namespace coup {
 
 class Judge : public Player {
 public:
-    Judge(Game& game, const std::string& name);
-    
-    std::string role() const override; // Return player's role
+    Judge(Game& game, const std::string& name) : Player(game, name, RoleId::Judge) {} // Blocks bribes (see Player::tryBlockBribe)
 };
 
-}
\ No newline at end of file
+}
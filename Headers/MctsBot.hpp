@@ -0,0 +1,76 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Game.hpp"
+#include "MoveList.hpp"
+
+namespace coup {
+
+// Search budget and tuning of the MCTS bot
+struct MctsConfig {
+    long iterations = 1000; // Number of playouts per move (0 for no limit - then timeLimitMs must be set)
+    long timeLimitMs = 0; // Wall-clock limit per move in milliseconds (0 for no limit)
+    double exploration = 1.41; // UCT exploration constant
+    int maxRolloutTurns = 200; // Rollouts longer than this are scored as a draw between the players left
+    bool heuristicRollouts = true; // Rollouts coup whenever they can (otherwise uniformly random)
+};
+
+// What the last search did
+struct MctsStats {
+    long playouts = 0; // Number of playouts (iterations) that were run
+    double milliseconds = 0; // Wall-clock time of the search
+    double playoutsPerSecond() const; // Engine speed: playouts per second of the last search
+};
+
+// Monte Carlo Tree Search player (UCT selection, random or heuristic rollouts).
+// Searches on a clone of the table with make/unmake (undo journal), then plays through the normal Game API.
+// All randomness comes from the table's own generator, so a game with bots replays exactly from its seed.
+class MctsBot {
+public:
+    static constexpr ActionId PASS = ActionId::Count; // Move of a player that has no legal move (the turn just passes)
+
+    explicit MctsBot(const MctsConfig& config = MctsConfig()); // Constructor
+
+    Move chooseMove(Game& game); // Searches and returns the best move for the player whose turn it is (draws from the game's generator)
+    ActionResult playTurn(Game& game, std::vector<std::string>& log); // Chooses a move for the current player and plays it
+
+    const MctsStats& lastStats() const; // Returns what the last search did
+    const MctsConfig& config() const; // Returns the search budget and tuning
+
+private:
+    // One node of the search tree - the position after `move` was played by `mover`
+    struct Node {
+        Move move; // Move that led here
+        Seat mover; // Seat that played the move
+        std::int32_t parent; // Index of the parent node (-1 for the root)
+        std::int32_t firstChild = -1; // Index of the first expanded child (-1 if none)
+        std::int32_t nextSibling = -1; // Index of the next child of the same parent (-1 if last)
+        // Untried moves without storing them: the node's legal moves are expanded in the order
+        // offset, offset + stride, ... (mod moveCount) - a random permutation, since stride is coprime to moveCount
+        std::uint32_t moveCount = 0; // Number of legal moves at the node
+        std::uint32_t tried = 0; // Number of them expanded so far
+        std::uint32_t offset = 0; // Index of the first move to expand
+        std::uint32_t stride = 1; // Step between the moves to expand
+        bool expanded = false; // Whether the fields above were filled in
+        long visits = 0; // Number of playouts through this node
+        double reward = 0; // Sum of the rewards of `mover` over those playouts
+
+        Node(const Move& move, Seat mover, std::int32_t parent) : move(move), mover(mover), parent(parent) {}
+    };
+
+    MctsConfig settings; // Search budget and tuning
+    MctsStats stats; // What the last search did
+    std::vector<Node> nodes; // The search tree (the root is nodes[0]), reused between searches
+
+    static MoveList movesOf(Game& game, Player* player); // Legal moves of a player (PASS when there are none)
+    static void startExpansion(Node& node, std::uint32_t moveCount, Rng& rng); // Draws the order the node's moves are expanded in
+    void apply(Game& game, Player* player, const Move& move); // Plays a move on the simulated table
+    std::int32_t selectChild(std::int32_t node) const; // UCT choice among the expanded children
+    Move rolloutMove(Game& game, Player* player) const; // Move of the rollout policy (drawn without listing the moves)
+    void rollout(Game& game, double reward[MAX_PLAYERS]); // Plays the game out and scores it for every seat
+};
+
+}
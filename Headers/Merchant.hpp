@@ -7,8 +7,7 @@ namespace coup {
 
 class Merchant : public Player {
 public:
-    Merchant(Game& game, const std::string& name);
-    std::string role() const override; // Return player's role
+    Merchant(Game& game, const std::string& name) : Player(game, name, RoleId::Merchant) {} // Earns a coin on rich turns (see Game::handleMerchantPassive)
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,172 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "Action.hpp"
+#include "GameState.hpp"
+
+namespace coup {
+
+// One legal move - an action and the seat it targets (NO_SEAT for actions without a target)
+struct Move {
+    ActionId action;
+    Seat target;
+};
+
+// List of moves that never allocates and stays small on any table: the moves without a target are kept as they are,
+// a targeted action keeps one seat mask of its targets, so no (action, target) pair is ever stored.
+// Moves come in a fixed order - the untargeted ones as pushed, then each targeted action (Arrest, Sanction, Coup,
+// BlockTax, BlockArrest, BlockCoup, BlockBribe) with its targets from the lowest seat.
+class MoveList {
+public:
+    static constexpr std::size_t UNTARGETED_CAPACITY = 5; // Gather, Tax, Bribe, Invest (or a bot's pass)
+    static constexpr std::size_t TARGETED_ACTIONS = 7; // Arrest, Sanction, Coup and the four block actions
+
+    class Iterator; // Walks the moves in list order (yields each Move by value)
+
+    void push(ActionId action, Seat target = NO_SEAT) noexcept; // Adds a move (adding a targeted move twice keeps one)
+    void setTargets(ActionId action, const SeatMask& targets) noexcept; // Sets every target of a targeted action at once
+    void keepOnly(ActionId action) noexcept; // Removes every move of the other actions
+    void clear() noexcept { *this = MoveList(); }
+
+    std::size_t size() const noexcept { return count; }
+    bool empty() const noexcept { return count == 0; }
+    Move operator[](std::size_t i) const noexcept; // The i-th move in list order - O(1) untargeted, one nthSeat otherwise
+    Iterator begin() const noexcept;
+    Iterator end() const noexcept;
+
+    bool contains(ActionId action, Seat target = NO_SEAT) const noexcept; // Checks if a move is in the list
+
+    // Slot of a targeted action in `targets` (TARGETED_ACTIONS for the actions without a target)
+    static constexpr std::size_t slotOf(ActionId action) noexcept {
+        switch (action) {
+            case ActionId::Arrest: return 0;
+            case ActionId::Sanction: return 1;
+            case ActionId::Coup: return 2;
+            case ActionId::BlockTax: return 3;
+            case ActionId::BlockArrest: return 4;
+            case ActionId::BlockCoup: return 5;
+            case ActionId::BlockBribe: return 6;
+            default: return TARGETED_ACTIONS;
+        }
+    }
+    static constexpr ActionId TARGETED[TARGETED_ACTIONS] = {ActionId::Arrest, ActionId::Sanction, ActionId::Coup,
+        ActionId::BlockTax, ActionId::BlockArrest, ActionId::BlockCoup, ActionId::BlockBribe};
+
+private:
+    Move untargeted[UNTARGETED_CAPACITY] = {};
+    std::uint8_t untargetedCount = 0;
+    std::uint32_t count = 0; // Number of moves
+    SeatMask targets[TARGETED_ACTIONS] = {}; // Targets of each targeted action
+};
+
+// Walks the moves in list order (the untargeted moves, then every target of each targeted action)
+class MoveList::Iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Move;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Move*;
+    using reference = Move;
+
+    Iterator(const MoveList* list, std::size_t index, std::size_t slot, Seat seat) : list(list), index(index), slot(slot), seat(seat) {}
+
+    Move operator*() const noexcept {
+        return index < list->untargetedCount ? list->untargeted[index] : Move{TARGETED[slot], seat};
+    }
+    Iterator& operator++() noexcept {
+        if (index < list->untargetedCount) {
+            if (++index == list->untargetedCount) seekSlot(0);
+        } else if ((seat = seatAfter(list->targets[slot], seat)) == NO_SEAT) {
+            seekSlot(slot + 1);
+        }
+        return *this;
+    }
+    bool operator==(const Iterator& other) const noexcept { return index == other.index && slot == other.slot && seat == other.seat; }
+    bool operator!=(const Iterator& other) const noexcept { return !(*this == other); }
+
+    void seekSlot(std::size_t from) noexcept { // Moves to the first target of the first non-empty slot from `from` (or the end)
+        for (slot = from; slot < TARGETED_ACTIONS; ++slot) {
+            if ((seat = firstSeat(list->targets[slot])) != NO_SEAT) return;
+        }
+        seat = NO_SEAT;
+    }
+
+private:
+    const MoveList* list;
+    std::size_t index; // Untargeted move (untargetedCount once past them)
+    std::size_t slot; // Targeted action (TARGETED_ACTIONS at the end)
+    Seat seat; // Target within the slot
+};
+
+// Adds a move (adding a targeted move twice keeps one)
+inline void MoveList::push(ActionId action, Seat target) noexcept {
+    if (target == NO_SEAT) {
+        untargeted[untargetedCount++] = Move{action, target};
+        ++count;
+        return;
+    }
+    SeatMask& mask = targets[slotOf(action)];
+    if (hasSeat(mask, target)) return;
+    addSeat(mask, target);
+    ++count;
+}
+
+// Sets every target of a targeted action at once (replaces the targets pushed before)
+inline void MoveList::setTargets(ActionId action, const SeatMask& seats) noexcept {
+    SeatMask& mask = targets[slotOf(action)];
+    count = count - seatCount(mask) + seatCount(seats);
+    mask = seats;
+}
+
+// Removes every move of the other actions
+inline void MoveList::keepOnly(ActionId action) noexcept {
+    std::uint8_t kept = 0;
+    for (std::uint8_t i = 0; i < untargetedCount; ++i) {
+        if (untargeted[i].action == action) untargeted[kept++] = untargeted[i];
+    }
+    untargetedCount = kept;
+    count = kept;
+    for (std::size_t slot = 0; slot < TARGETED_ACTIONS; ++slot) {
+        if (TARGETED[slot] != action) targets[slot] = SeatMask{};
+        count += seatCount(targets[slot]);
+    }
+}
+
+// The i-th move in list order
+inline Move MoveList::operator[](std::size_t i) const noexcept {
+    if (i < untargetedCount) return untargeted[i];
+    i -= untargetedCount;
+    for (std::size_t slot = 0; slot < TARGETED_ACTIONS; ++slot) {
+        const std::size_t n = seatCount(targets[slot]);
+        if (i < n) return Move{TARGETED[slot], nthSeat(targets[slot], static_cast<unsigned>(i))};
+        i -= n;
+    }
+    return Move{ActionId::Count, NO_SEAT};
+}
+
+inline MoveList::Iterator MoveList::begin() const noexcept {
+    Iterator it(this, 0, 0, NO_SEAT);
+    if (untargetedCount == 0) it.seekSlot(0);
+    return it;
+}
+
+inline MoveList::Iterator MoveList::end() const noexcept {
+    return Iterator(this, untargetedCount, TARGETED_ACTIONS, NO_SEAT);
+}
+
+// Checks if a move is in the list
+inline bool MoveList::contains(ActionId action, Seat target) const noexcept {
+    if (target != NO_SEAT) {
+        const std::size_t slot = slotOf(action);
+        return slot < TARGETED_ACTIONS && hasSeat(targets[slot], target);
+    }
+    for (std::uint8_t i = 0; i < untargetedCount; ++i) {
+        if (untargeted[i].action == action) return true;
+    }
+    return false;
+}
+
+}
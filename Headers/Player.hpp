@@ -4,35 +4,32 @@
 #include <string>
 #include <vector>
 #include <stdexcept>
+#include <cstdint>
+#include "Role.hpp"
+#include "Action.hpp"
+#include "GameState.hpp"
 
 namespace coup {
 
 class Game;
-
-struct PlayerState {
-    bool isSanctioned = false; // The player can't preform tax & gather actions for his next turn
-    bool isTaxBlocked = false; // The player can't preform tax action for his next turn
-    bool isArrestedBlocked = false; // The player can't preform arrest action for his next turn
-    bool isRecentlyArrested = false; // for arrest cooldown logic
-    bool isBribeBlocked = false; // The player can't preform bribe action for his next turn
-    bool bribedThisTurn = false; // The player can preform 2 actions on his turn
-    bool onCoupTrial = false; // The player was tagged for a coup, only the general can undo this. On his next turn he will be terminated
-    bool active = true; // The player is in/out of the game
-};
+struct RuleTable;
 
 class Player {
+    friend class Game; // The game assigns the seat when the player joins and rebinds it on move/clone
 
-    
 protected:
-    Game& game; // Game instance
+    Game* game; // Game instance (re-pointed when the game is moved or cloned)
+    const GameState* table; // State of the game - the getters below read the seat's flags and coins from it inline
     std::string name; // Player's name
-    int coin_count = 0; // Player's coins
-    PlayerState state; // Struct for player's state (sanction,tax blocked, etc..)
-    void validateAction(const std::string& actionName = "") const; // Helper method to validate action and save duplicated code
+    RoleId role_id; // Player's role tag (set once by the constructor of each role)
+    Seat seat = 0; // Index of the player's seat in the game state (coins and state flags live there)
+    template <typename R> ActionResult checkAction(const R& rules, ActionId action) const; // Helper method to validate action and save duplicated code (turn, sanction, arrest block, forced coup)
+    bool mayUse(ActionId action) const; // Whether the player's role may use an action under the rules of his game
+    void throwIfFailed(ActionResult result, ActionId action, const Player* target = nullptr) const; // Throws the text of a failed result (throwing API)
 
 public:
-    Player(Game& game, const std::string& name); // Constructor
-    virtual ~Player() = default; // Default destructor
+    Player(Game& game, const std::string& name, RoleId role); // Constructor
+    virtual ~Player() = default; // Default destructor (the only virtual - role rules are switched on role_id)
 
     // Special actions that are role based
     void blockTax(Player& target);  // Governor only method that blocks the tax action on another player
@@ -40,29 +37,51 @@ public:
     void blockCoup(Player& target); // General only method that blocks the coup action on another player, or prevents elimination on another player
     void blockBribe(Player& target); // Judge only method that blocks the bribe action on another player
 
+    // Same as above, but return why the move was refused instead of throwing
+    ActionResult tryBlockTax(Player& target);
+    ActionResult tryBlockArrest(Player& target);
+    ActionResult tryBlockCoup(Player& target);
+    ActionResult tryBlockBribe(Player& target);
+
+    // Role specials, checked against the role tag (no cast needed - other roles get ActionResult::WrongRole)
+    ActionResult tryInvest(); // Baron: pays 3 coins and gets 6 (counts as a turn)
+    ActionResult tryPreventCoup(Player& target); // General: pays 5 coins to take a player off coup trial
+
     // Helper functions for managing actions logic
-    bool onTaxBlocked() const; // Helper function to governor that checks if player is blocked on tax
-    bool onArrestedBlocked() const; // Helper function to spy that checks if player is blocked on arrest
-    bool onCoupTrial() const; // Helper function to general that checks if player is on coop trial
-    bool onBribe() const; // Helper function to judge that checks if player has taken a bribe (for 2 actions on a turn)
+    bool onTaxBlocked() const { return table->flags[seat] & FLAG_TAX_BLOCKED; } // Helper function to governor that checks if player is blocked on tax
+    bool onArrestedBlocked() const { return table->flags[seat] & FLAG_ARREST_BLOCKED; } // Helper function to spy that checks if player is blocked on arrest
+    bool onCoupTrial() const { return table->flags[seat] & FLAG_COUP_TRIAL; } // Helper function to general that checks if player is on coop trial
+    bool onBribe() const { return table->did_pay_bribe && table->current_turn == seat; } // Helper function to judge that checks if player has taken a bribe (for 2 actions on a turn)
     void usedBribeTurn(); // Function that resets "bribedThisTurn" flag in player state - called after the player used his bribe turn
-    virtual bool onSanctioned() const; // Helper function to see sanction state
+    bool onSanctioned() const { return table->flags[seat] & FLAG_SANCTIONED; } // Helper function to see sanction state
+    bool mustCoup() const; // Whether the player is forced to coup this turn (enough coins for the forced coup, and he can pay for one)
 
     void eliminate(); // Function that eliminates a player that reached his turn in a on coup trial state
     
     // Getters
     std::string getName() const; // Getter for player's name
-    int coins() const; // Getter for number of coins the player has
-    bool isActive() const; // Returns the state of player
-    virtual std::string role() const = 0; // Pure virtual function that returns from each player it's role
-
-    // Actions
-    virtual void gather(); // Function for the action "Gather" that gives the player 1 coin
-    virtual void tax(); // Function for the action "Tax" that gives the player 2 coins 
-    virtual void bribe(); // Function for the action "Bribe" that gives the player another turn
-    virtual void arrest(Player& target); // Function for the action "Arrest" that steals one coin from a target player and gives the caller 1 coin
-    virtual void sanction(Player& target); // Function for the action "Sanction" that blocks the targeted player from using Tax & Gather (costs 3 coins to the caller)
-    virtual void coup(Player& target); // Function for the action "Coup" that places the targeted player on "coup trial" (costs 7 coins to the caller)
+    int coins() const { return table->coins[seat]; } // Getter for number of coins the player has
+    bool isActive() const { return table->flags[seat] & FLAG_ACTIVE; } // Returns the state of player
+    std::size_t seatIndex() const { return seat; } // Returns the seat of the player in the game state
+    RoleId roleId() const { return role_id; } // Returns the role tag of the player (used by all rule checks)
+    const RuleTable& rules() const; // Returns the rules of the player's game as a table
+    std::string role() const; // Returns the role name of the player (display only)
+
+    // Actions (throw std::runtime_error on an illegal move)
+    void gather(); // Function for the action "Gather" that gives the player 1 coin
+    void tax(); // Function for the action "Tax" that gives the player 2 coins 
+    void bribe(); // Function for the action "Bribe" that gives the player another turn
+    void arrest(Player& target); // Function for the action "Arrest" that steals one coin from a target player and gives the caller 1 coin
+    void sanction(Player& target); // Function for the action "Sanction" that blocks the targeted player from using Tax & Gather (costs 3 coins to the caller)
+    void coup(Player& target); // Function for the action "Coup" that places the targeted player on "coup trial" (costs 7 coins to the caller)
+
+    // Same actions without exceptions - nothing changes unless the result is ActionResult::Ok
+    ActionResult tryGather();
+    ActionResult tryTax(); // A Governor gets 3 coins instead of 2
+    ActionResult tryBribe();
+    ActionResult tryArrest(Player& target);
+    ActionResult trySanction(Player& target);
+    ActionResult tryCoup(Player& target);
 
     void resetTurnFlags(); // Resets state flags of actions that are blocking action for one turn
     
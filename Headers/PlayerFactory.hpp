@@ -13,5 +13,7 @@
 #include "General.hpp"
 
 namespace coup {
-    Player* createPlayerByRole(const std::string& role, Game& game, const std::string& name);
+    Player* createPlayerByRole(RoleId role, Game& game, const std::string& name);
+    Player* createPlayerByRole(RoleId role, Game& game, const std::string& name, PlayerSlot& slot); // Builds the player in `slot` (destroy with ~Player, not delete)
+    Player* createPlayerByRole(const std::string& role, Game& game, const std::string& name); // Parses the role name first
 }
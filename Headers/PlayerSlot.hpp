@@ -0,0 +1,17 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <type_traits>
+#include "Baron.hpp"
+#include "Spy.hpp"
+#include "Governor.hpp"
+#include "Merchant.hpp"
+#include "Judge.hpp"
+#include "General.hpp"
+
+namespace coup {
+
+// Raw storage that fits a player of any role - Game keeps one per seat and the factory builds players in place
+using PlayerSlot = std::aligned_union_t<0, Baron, Spy, Governor, Merchant, Judge, General>;
+
+}
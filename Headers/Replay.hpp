@@ -0,0 +1,166 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Action.hpp"
+#include "GameState.hpp"
+#include "Role.hpp"
+
+namespace coup {
+
+class Game;
+struct RuleTable;
+
+// Binary replay format (all integers are LEB128 varints unless noted):
+//   header: "CPRP" | version (1 byte) | seed | rules fingerprint (8 bytes, little-endian) | seat count (1 byte) |
+//           per seat: role (1 byte), name length, name bytes
+//   steps:  one varint per state-changing call, packed as kind + 8 * (action + ACTION_COUNT * (actor + seats * (target + 1)))
+//   keyframes (optional, every N steps): the varint 5 (kind 5, nothing else) | per seat: zigzag coins, flags (1 byte) |
+//            current_turn, did_pay_bribe, last_arrested, last_turn (1 byte each) - the whole table after the step before it
+// A six-seat game takes 1-2 bytes per step and 17 bytes per keyframe.
+
+constexpr std::uint8_t REPLAY_VERSION = 3; // Bumped whenever the layout above changes (version 1 had no keyframes, 2 no rules fingerprint)
+
+// Which entry point a step replays
+enum class StepKind : std::uint8_t {
+    Turn, // handleTurnWithTarget / handleTurnWithNoTarget (actor played action on target)
+    Block, // handleBlockConsequences (actor blocked target's action and paid for it)
+    MerchantPassive, // handleMerchantPassive (actor got his passive coin)
+    Eliminated, // checkElimination (actor was eliminated by an unresolved coup)
+    Pass, // passTurn (actor had no legal move)
+};
+
+constexpr unsigned STEP_KINDS = 8; // Radix of the kind field (room for new kinds without changing the packing)
+
+// One decoded step
+struct ReplayStep {
+    StepKind kind;
+    ActionId action; // ActionId::Gather for steps without an action
+    Seat actor; // Seat that acted
+    Seat target; // Seat that was targeted (NO_SEAT if none)
+};
+
+// Seed, rules and seats of a recorded game
+struct ReplayHeader {
+    std::uint64_t seed = 0; // Seed of the recorded table
+    std::uint64_t rulesFingerprint = 0; // fingerprintRules of the rules it played by (0 in replays older than version 3)
+    std::vector<std::string> names; // Name of each seat
+    std::vector<RoleId> roles; // Role of each seat
+};
+
+// Forward iterator over the steps of a replay, decoded in place (no allocation, keyframes are skipped)
+class StepIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = ReplayStep;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const ReplayStep*;
+    using reference = const ReplayStep&;
+
+    StepIterator() = default;
+    StepIterator(const std::uint8_t* data, const std::uint8_t* end, std::uint8_t seats); // Iterator at the first step at or after `data`
+
+    reference operator*() const { return step; }
+    pointer operator->() const { return &step; }
+    StepIterator& operator++();
+    StepIterator operator++(int);
+    bool operator==(const StepIterator& other) const { return at == other.at; }
+    bool operator!=(const StepIterator& other) const { return at != other.at; }
+
+private:
+    const std::uint8_t* at = nullptr; // Where decoding of the current step started (the end of the replay when done)
+    const std::uint8_t* after = nullptr; // First byte after the current step
+    const std::uint8_t* last = nullptr; // End of the replay
+    std::uint8_t seats = 0; // Seat count of the replay (radix of the seat fields)
+    ReplayStep step{}; // Decoded current step
+
+    void load(const std::uint8_t* p); // Decodes the step at or after `p` (or becomes the end iterator)
+};
+
+// The steps of one replay, for range-for loops
+class ReplaySteps {
+public:
+    ReplaySteps(const std::uint8_t* first, const std::uint8_t* last, std::uint8_t seats);
+    StepIterator begin() const;
+    StepIterator end() const;
+
+private:
+    const std::uint8_t* first; // First step byte
+    const std::uint8_t* last; // End of the replay
+    std::uint8_t seats; // Seat count of the replay
+};
+
+// Appends the steps of a game to a byte buffer (attach with Game::recordTo)
+class ReplayWriter {
+public:
+    // Writes the header of a seated table (at most 254 seats, throws std::length_error) - set its rules first, the header
+    // stores their fingerprint. With keyframeInterval > 0 the table is stored every that many steps,
+    // so a reader can seek without replaying from the start (smaller interval: faster seeks, bigger file).
+    explicit ReplayWriter(const Game& game, std::size_t keyframeInterval = 0);
+
+    void record(StepKind kind, ActionId action, Seat actor, Seat target = NO_SEAT); // Appends one step
+    bool keyframeDue() const; // Whether a keyframe interval has passed since the last keyframe
+    void keyframe(const GameState& state); // Appends the whole table as it is after the last step
+
+    const std::vector<std::uint8_t>& bytes() const; // Returns the encoded replay (header and steps)
+    std::size_t steps() const; // Number of recorded steps
+    void save(const std::string& path) const; // Writes the replay to a file (throws on I/O errors)
+
+private:
+    std::vector<std::uint8_t> buffer; // Encoded replay
+    std::uint8_t seats; // Seat count of the table (radix of the seat fields)
+    std::size_t count = 0; // Number of recorded steps
+    std::size_t interval; // Steps between keyframes (0 for none)
+    std::size_t lastKeyframe = 0; // Step count at the last keyframe
+};
+
+// Decodes a replay in place - the bytes are not copied and must outlive the reader
+class ReplayReader {
+public:
+    ReplayReader(const std::uint8_t* data, std::size_t size); // Parses the header (throws std::runtime_error on a bad replay)
+    explicit ReplayReader(const std::vector<std::uint8_t>& bytes);
+
+    const ReplayHeader& header() const; // Returns the seed and seats of the game
+    bool next(ReplayStep& step); // Decodes the next step, skipping keyframes (false at the end of the replay)
+    void rewind(); // Goes back to the first step
+    std::size_t position() const; // Number of steps decoded since the start
+    ReplaySteps steps() const; // Every step of the replay, decoded in place (independent of next())
+
+    // Puts `game` (a table of this replay, see gameFromReplay) in the state after `step` steps: restores the
+    // nearest keyframe at or before it and replays only the steps after that. The game keeps its rules.
+    // Returns the step reached (less than `step` if the replay is shorter). Throws if a step is refused.
+    std::size_t seek(Game& game, std::size_t step);
+
+private:
+    // Where a keyframe is and how many steps come before it
+    struct Keyframe {
+        std::size_t step;
+        const std::uint8_t* data; // First byte of the stored table
+    };
+
+    ReplayHeader info; // Parsed header
+    const std::uint8_t* first; // First step byte
+    const std::uint8_t* cursor; // Next step byte
+    const std::uint8_t* last; // End of the replay
+    std::size_t decoded = 0; // Steps decoded since the start
+    std::vector<Keyframe> keyframes; // Keyframes of the replay (built on the first seek)
+    bool indexed = false; // Whether `keyframes` was built
+
+    void loadKeyframe(Game& game, const std::uint8_t* p) const; // Restores a stored table into a game
+};
+
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value); // Appends a LEB128 varint
+std::uint64_t getVarint(const std::uint8_t*& p, const std::uint8_t* end); // Reads a LEB128 varint (throws if it runs past the end)
+std::vector<std::uint8_t> loadReplay(const std::string& path); // Reads a replay file (throws on I/O errors)
+ReplaySteps replaySteps(const std::uint8_t* data, std::size_t size); // Steps of a replay, read in place (header checked, names not copied)
+// Returns the table of a replay before its first step, playing by `rules` (the built-in rules if nullptr - the table must
+// outlive the game). Throws std::runtime_error if the replay was recorded under other rules.
+Game gameFromReplay(const ReplayHeader& header, const RuleTable* rules = nullptr);
+bool applyStep(Game& game, const ReplayStep& step); // Plays one step (false if the game refuses it - the replay does not match)
+long replayGame(Game& game, ReplayReader& reader); // Plays every remaining step, returns their number (throws if a step is refused)
+
+}
@@ -0,0 +1,116 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Replay.hpp"
+
+namespace coup {
+
+// Archive of many replays in one file (varints as in Replay.hpp):
+//   "CPRA" | version (1 byte) | per game: replay length, replay bytes
+//   footer (written by ArchiveWriter::close): game count | checkpoint count | offset of every checkpoint game |
+//           footer start (8 bytes, little endian) | "CPRE"
+// An archive without a footer (the writer did not finish) is still readable - the checkpoints are then found by
+// walking the game lengths once, and a last game cut off in the middle is left out.
+
+constexpr std::uint8_t ARCHIVE_VERSION = 1; // Bumped whenever the layout above changes
+constexpr std::size_t ARCHIVE_CHECKPOINT = 1024; // Default number of games between two checkpoints (partition granularity)
+
+// One replay inside an archive (points into the mapped file)
+struct ReplayView {
+    const std::uint8_t* data;
+    std::size_t size;
+
+    ReplaySteps steps() const { return replaySteps(data, size); } // Steps of the game, decoded in place
+};
+
+// Appends replays to an archive file
+class ArchiveWriter {
+public:
+    explicit ArchiveWriter(const std::string& path, std::size_t checkpointEvery = ARCHIVE_CHECKPOINT); // Creates the file (throws on I/O errors)
+    ~ArchiveWriter(); // Writes the footer if close() was not called
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    void add(const ReplayWriter& replay); // Appends the replay of a game
+    void add(const std::uint8_t* data, std::size_t size); // Appends an encoded replay
+    void close(); // Writes the footer and closes the file (throws on I/O errors)
+    std::size_t games() const; // Number of games written
+
+private:
+    std::ofstream file; // Archive being written
+    std::uint64_t offset = 0; // Bytes written so far
+    std::size_t count = 0; // Games written so far
+    std::size_t interval; // Games between two checkpoints
+    std::vector<std::uint64_t> checkpoints; // Offset of every checkpoint game
+    bool closed = false; // Whether the footer was written
+};
+
+// Consecutive games of an archive. Ranges from ReplayArchive::partition never overlap, so each thread can scan one.
+class ArchiveRange {
+public:
+    // Forward iterator over the games of the range
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ReplayView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const ReplayView*;
+        using reference = const ReplayView&;
+
+        iterator() = default;
+        iterator(const std::uint8_t* at, const std::uint8_t* end); // Iterator at the game that starts at `at`
+
+        reference operator*() const { return game; }
+        pointer operator->() const { return &game; }
+        iterator& operator++();
+        iterator operator++(int);
+        bool operator==(const iterator& other) const { return at == other.at; }
+        bool operator!=(const iterator& other) const { return at != other.at; }
+
+    private:
+        const std::uint8_t* at = nullptr; // Length prefix of the current game (the end of the range when done)
+        const std::uint8_t* last = nullptr; // End of the range
+        ReplayView game{nullptr, 0}; // Current game
+
+        void load(); // Reads the game at `at`
+    };
+
+    ArchiveRange(const std::uint8_t* first, const std::uint8_t* last); // Games between two game boundaries
+
+    iterator begin() const;
+    iterator end() const;
+    std::size_t bytes() const; // Size of the range in the file
+
+private:
+    const std::uint8_t* first; // Length prefix of the first game
+    const std::uint8_t* last; // End of the last game
+};
+
+// Read-only, memory-mapped archive - games and steps are decoded straight from the mapping, nothing is copied
+class ReplayArchive {
+public:
+    explicit ReplayArchive(const std::string& path); // Maps the file (throws std::runtime_error on a bad archive)
+    ~ReplayArchive(); // Unmaps the file
+    ReplayArchive(const ReplayArchive&) = delete;
+    ReplayArchive& operator=(const ReplayArchive&) = delete;
+
+    std::size_t games() const; // Number of games in the archive
+    ArchiveRange all() const; // Every game of the archive
+    std::vector<ArchiveRange> partition(std::size_t parts) const; // Up to `parts` disjoint ranges of about equal size covering every game
+
+private:
+    const std::uint8_t* base = nullptr; // Start of the mapping
+    std::size_t length = 0; // Size of the mapping
+    const std::uint8_t* gamesBegin = nullptr; // First game
+    const std::uint8_t* gamesEnd = nullptr; // End of the last game (the footer starts here)
+    std::size_t count = 0; // Number of games
+    std::vector<std::uint64_t> checkpoints; // Offset of every checkpoint game (partition boundaries)
+};
+
+}
@@ -0,0 +1,83 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace coup {
+
+// xoshiro256** random generator - 32 bytes of state (mt19937 carries 5 KB), fast, and good enough for games.
+// Seeded through splitmix64, so any 64-bit seed (even 0) gives a well mixed state.
+// Meets the UniformRandomBitGenerator requirements, so it also works with <random> distributions.
+class Rng {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Rng(std::uint64_t seed = 0) { reseed(seed); } // Constructor
+
+    // Restarts the generator from a seed
+    void reseed(std::uint64_t seed) {
+        initial = seed;
+        for (std::uint64_t& word : state) word = splitmix(seed);
+    }
+
+    std::uint64_t seed() const { return initial; } // Seed the generator was started from
+
+    // Next 64 random bits
+    std::uint64_t operator()() {
+        const std::uint64_t result = rotl(state[1] * 5, 7) * 9;
+        const std::uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // Uniform number in [0, bound) without modulo bias (Lemire's multiply-shift method)
+    std::uint32_t below(std::uint32_t bound) {
+        std::uint64_t m = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)() >> 32)) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(m);
+        if (low < bound) {
+            const std::uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                m = static_cast<std::uint64_t>(static_cast<std::uint32_t>((*this)() >> 32)) * bound;
+                low = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+    // Seed of stream `index` of a master seed - independent seeds for game 0, 1, 2... of a batch
+    static std::uint64_t streamSeed(std::uint64_t master, std::uint64_t index) {
+        std::uint64_t x = master + 0x9E3779B97F4A7C15ULL * index;
+        return splitmix(x);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    // Two generators are equal when they will produce the same numbers
+    bool operator==(const Rng& other) const {
+        return state[0] == other.state[0] && state[1] == other.state[1] && state[2] == other.state[2] && state[3] == other.state[3];
+    }
+    bool operator!=(const Rng& other) const { return !(*this == other); }
+
+private:
+    std::uint64_t state[4]; // Generator state
+    std::uint64_t initial = 0; // Seed the generator was started from
+
+    static std::uint64_t rotl(std::uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    // splitmix64 step - advances `x` and returns the next mixed value
+    static std::uint64_t splitmix(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+};
+
+}
@@ -0,0 +1,26 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace coup {
+
+// Compact tag of a player's role - rule checks compare these instead of role names
+enum class RoleId : std::uint8_t {
+    Baron,
+    Spy,
+    Governor,
+    Merchant,
+    Judge,
+    General,
+    None // No role (used by the rules for actions anyone can use / no one can block)
+};
+
+constexpr std::size_t ROLE_COUNT = static_cast<std::size_t>(RoleId::None);
+
+const char* roleName(RoleId role); // Returns the display name of a role
+bool parseRole(const std::string& name, RoleId& role); // Converts a role name into a role id (GUI / CLI boundary only)
+
+}
@@ -0,0 +1,145 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "Action.hpp"
+#include "Role.hpp"
+#include "Rules.hpp"
+
+namespace coup {
+
+// Rules loaded at runtime, compiled into flat arrays indexed by ActionId / RoleId. The turn code reads one entry
+// instead of comparing roles, so a rules file changes costs and abilities without a rebuild (see Rules/standard.rules).
+// Build it once - loadRules() at startup - and hand it to every game with Game::setRules.
+struct RuleTable {
+    std::int16_t cost[ACTION_COUNT]; // Coins an action costs its player
+    RoleId blockedBy[ACTION_COUNT]; // Role that can block the action (RoleId::None if none)
+    std::int16_t blockCost[ACTION_COUNT]; // Coins the blocker pays to block the action on another player's turn
+    std::int16_t blockPenalty[ACTION_COUNT]; // Coins the player still loses when his action is blocked
+    std::uint16_t allowedActions[ROLE_COUNT]; // Bit (1 << ActionId) of every action a role may use
+
+    std::int16_t gatherGain; // Coins from Gather
+    std::int16_t taxGain[ROLE_COUNT]; // Coins from Tax
+    std::int16_t investReturn; // Coins Invest pays back
+    std::int16_t forcedCoupCoins; // From this many coins the only legal action is a Coup
+
+    std::int16_t arrestLoss[ROLE_COUNT]; // Coins an arrested player pays (he can't be arrested with fewer)
+    std::int16_t arrestGain[ROLE_COUNT]; // Coins the arrester gets from him
+    std::int16_t arrestRefund[ROLE_COUNT]; // Coins the arrested player gets back afterwards
+    std::int16_t sanctionSurcharge[ROLE_COUNT]; // Extra coins it costs to sanction the role
+    std::int16_t sanctionRefund[ROLE_COUNT]; // Coins a sanctioned player of the role gets as compensation
+    std::int16_t passiveThreshold[ROLE_COUNT]; // Coins the role needs at the start of his turn for the passive gain
+    std::int16_t passiveGain[ROLE_COUNT]; // Passive coins the role gets at the start of his turn (0 for none)
+
+    bool mayUse(RoleId role, ActionId action) const noexcept {
+        return allowedActions[static_cast<std::size_t>(role)] & (1u << static_cast<unsigned>(action));
+    }
+    RoleId requiredRole(ActionId action) const noexcept; // The only role allowed to use the action (RoleId::None if more)
+    bool operator==(const RuleTable& other) const noexcept;
+    bool operator!=(const RuleTable& other) const noexcept { return !(*this == other); }
+};
+
+static_assert(ACTION_COUNT <= 16, "allowedActions holds one bit per action");
+
+// The turn code is written once against a rules view and instantiated for both kinds of rules (see Game::withRules):
+// PolicyRules<Rules> folds every lookup into a constant, TableRules reads a RuleTable. Both answer the same calls.
+
+// Rules view of a compile-time policy (Rules.hpp) - every call is a constant expression
+template <typename P>
+struct PolicyRules {
+    static constexpr const char* NAME = P::NAME;
+
+    static constexpr int cost(ActionId action) {
+        switch (action) {
+            case ActionId::Bribe: return P::BRIBE_COST;
+            case ActionId::Sanction: return P::SANCTION_COST;
+            case ActionId::Coup: return P::COUP_COST;
+            case ActionId::Invest: return P::INVEST_COST;
+            case ActionId::BlockCoup: return P::BLOCK_COUP_COST;
+            default: return 0;
+        }
+    }
+    static constexpr bool mayUse(RoleId role, ActionId action) {
+        return P::requiredRole(action) == RoleId::None || P::requiredRole(action) == role;
+    }
+    static constexpr RoleId blockedBy(ActionId action) { return P::blockedBy(action); }
+    static constexpr int blockCost(ActionId action) { return action == ActionId::Coup ? P::BLOCK_COUP_COST : 0; }
+    static constexpr int blockPenalty(ActionId action) {
+        return action == ActionId::Bribe ? P::BRIBE_COST : action == ActionId::Coup ? P::COUP_COST : 0;
+    }
+
+    static constexpr int gatherGain() { return P::GATHER_GAIN; }
+    static constexpr int taxGain(RoleId role) { return role == RoleId::Governor ? P::GOVERNOR_TAX_GAIN : P::TAX_GAIN; }
+    static constexpr int investReturn() { return P::INVEST_RETURN; }
+    static constexpr int forcedCoupCoins() { return P::FORCED_COUP_COINS; }
+
+    static constexpr int arrestLoss(RoleId role) { return role == RoleId::Merchant ? P::MERCHANT_ARREST_LOSS : P::ARREST_STEAL; }
+    static constexpr int arrestGain(RoleId role) { return role == RoleId::Merchant ? 0 : P::ARREST_STEAL; } // The Merchant pays the bank
+    static constexpr int arrestRefund(RoleId role) { return role == RoleId::General ? P::GENERAL_ARREST_REFUND : 0; }
+    static constexpr int sanctionSurcharge(RoleId role) { return role == RoleId::Judge ? P::JUDGE_SANCTION_SURCHARGE : 0; }
+    static constexpr int sanctionRefund(RoleId role) { return role == RoleId::Baron ? P::BARON_SANCTION_REFUND : 0; }
+    static constexpr int passiveThreshold(RoleId role) { return role == RoleId::Merchant ? P::MERCHANT_PASSIVE_COINS : 0; }
+    static constexpr int passiveGain(RoleId role) { return role == RoleId::Merchant ? P::MERCHANT_PASSIVE_GAIN : 0; }
+};
+
+// Rules view of a RuleTable - one array read per call
+struct TableRules {
+    const RuleTable* table;
+
+    int cost(ActionId action) const { return table->cost[static_cast<std::size_t>(action)]; }
+    bool mayUse(RoleId role, ActionId action) const { return table->mayUse(role, action); }
+    RoleId blockedBy(ActionId action) const { return table->blockedBy[static_cast<std::size_t>(action)]; }
+    int blockCost(ActionId action) const { return table->blockCost[static_cast<std::size_t>(action)]; }
+    int blockPenalty(ActionId action) const { return table->blockPenalty[static_cast<std::size_t>(action)]; }
+
+    int gatherGain() const { return table->gatherGain; }
+    int taxGain(RoleId role) const { return table->taxGain[static_cast<std::size_t>(role)]; }
+    int investReturn() const { return table->investReturn; }
+    int forcedCoupCoins() const { return table->forcedCoupCoins; }
+
+    int arrestLoss(RoleId role) const { return table->arrestLoss[static_cast<std::size_t>(role)]; }
+    int arrestGain(RoleId role) const { return table->arrestGain[static_cast<std::size_t>(role)]; }
+    int arrestRefund(RoleId role) const { return table->arrestRefund[static_cast<std::size_t>(role)]; }
+    int sanctionSurcharge(RoleId role) const { return table->sanctionSurcharge[static_cast<std::size_t>(role)]; }
+    int sanctionRefund(RoleId role) const { return table->sanctionRefund[static_cast<std::size_t>(role)]; }
+    int passiveThreshold(RoleId role) const { return table->passiveThreshold[static_cast<std::size_t>(role)]; }
+    int passiveGain(RoleId role) const { return table->passiveGain[static_cast<std::size_t>(role)]; }
+};
+
+// Compile-time policies one binary can play by, each compiled to its own constants - variant 0 is Rules, the one the
+// build picked with -DCOUP_RULES. Game::setRules(variantRules(i)) makes a table play by variant i.
+using RuleVariants = std::tuple<Rules, StandardRules, QuickCoupRules>;
+constexpr std::size_t RULE_VARIANT_COUNT = std::tuple_size<RuleVariants>::value;
+
+// Runs `body` with the rules view of a variant (variant < RULE_VARIANT_COUNT)
+template <std::size_t I = 0, typename Body>
+decltype(auto) withRuleVariant(std::size_t variant, Body&& body) {
+    using Policy = std::tuple_element_t<I, RuleVariants>;
+    if constexpr (I + 1 == RULE_VARIANT_COUNT) {
+        return body(PolicyRules<Policy>());
+    }
+    else {
+        if (variant == I) return body(PolicyRules<Policy>());
+        return withRuleVariant<I + 1>(variant, std::forward<Body>(body));
+    }
+}
+
+const RuleTable& variantRules(std::size_t variant); // A compile-time variant as a table
+std::size_t variantOf(const RuleTable& rules); // Variant whose table `rules` is (RULE_VARIANT_COUNT for any other table)
+const char* ruleVariantName(std::size_t variant); // NAME of a variant
+bool parseRuleVariant(const std::string& name, std::size_t& variant); // Finds a variant by its NAME (false if none)
+const RuleTable& defaultRules(); // The built-in Rules policy as a table (what a rules file starts from) - variantRules(0)
+
+std::uint64_t fingerprintRules(const RuleTable& rules); // Hash of every setting - replays store it to refuse other rules
+
+// Compiles a rules file on top of the default rules (only the lines in the file change anything).
+// Throws std::invalid_argument with the line number on a bad line, or if the forced coup can't be played.
+RuleTable parseRules(std::istream& in, const std::string& source = "rules");
+RuleTable loadRules(const std::string& path); // Same as parseRules on a file (throws std::runtime_error if it can't be read)
+
+}
@@ -0,0 +1,71 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include "Action.hpp"
+#include "Role.hpp"
+
+namespace coup {
+
+// Every cost, threshold and role ability of the rules as compile-time constants. The engine reads them through
+// PolicyRules (RuleTable.hpp), so a house-rule variant is a struct with the same members. Each variant listed in
+// RuleVariants compiles to plain constants - nothing is looked up - and a game picks one with Game::setRules.
+// -DCOUP_RULES=<struct> (e.g. make simulate RULES=QuickCoupRules) picks the default one every game starts with.
+// They are also the defaults of a RuleTable (defaultRules), which a rules file can change without a rebuild.
+struct StandardRules {
+    static constexpr const char* NAME = "StandardRules"; // Printed by the simulator
+    static constexpr int GATHER_GAIN = 1; // Coins from Gather
+    static constexpr int TAX_GAIN = 2; // Coins from Tax
+    static constexpr int GOVERNOR_TAX_GAIN = 3; // Coins from Tax for a Governor
+    static constexpr int BRIBE_COST = 4; // Price of an extra action (also lost when a Judge blocks it)
+    static constexpr int ARREST_STEAL = 1; // Coins the arrester takes from the target
+    static constexpr int GENERAL_ARREST_REFUND = 1; // Coins an arrested General gets back
+    static constexpr int MERCHANT_ARREST_LOSS = 2; // Coins an arrested Merchant pays to the bank (the arrester gets none)
+    static constexpr int SANCTION_COST = 3; // Price of a Sanction
+    static constexpr int JUDGE_SANCTION_SURCHARGE = 1; // Extra price of sanctioning a Judge
+    static constexpr int BARON_SANCTION_REFUND = 1; // Coins a sanctioned Baron gets as compensation
+    static constexpr int COUP_COST = 7; // Price of a Coup (also lost when a General blocks it)
+    static constexpr int FORCED_COUP_COINS = 10; // From this many coins the only legal action is a Coup
+    static constexpr int INVEST_COST = 3; // Price of the Baron's Invest
+    static constexpr int INVEST_RETURN = 6; // Coins the Baron's Invest pays back
+    static constexpr int BLOCK_COUP_COST = 5; // Price of a General's coup block
+    static constexpr int MERCHANT_PASSIVE_COINS = 3; // A Merchant starting his turn with this many coins ...
+    static constexpr int MERCHANT_PASSIVE_GAIN = 1; // ... gets this many for free
+
+    // The only role that may use an action (RoleId::None if every role may)
+    static constexpr RoleId requiredRole(ActionId action) {
+        switch (action) {
+            case ActionId::Invest: return RoleId::Baron;
+            case ActionId::BlockTax: return RoleId::Governor;
+            case ActionId::BlockArrest: return RoleId::Spy;
+            case ActionId::BlockCoup: return RoleId::General;
+            case ActionId::BlockBribe: return RoleId::Judge;
+            default: return RoleId::None;
+        }
+    }
+
+    // The role that can block an action on another player's turn (RoleId::None if none)
+    static constexpr RoleId blockedBy(ActionId action) {
+        switch (action) {
+            case ActionId::Tax: return RoleId::Governor;
+            case ActionId::Arrest: return RoleId::Spy;
+            case ActionId::Bribe: return RoleId::Judge;
+            case ActionId::Coup: return RoleId::General;
+            default: return RoleId::None;
+        }
+    }
+};
+
+// Example variant: cheaper coups that are forced earlier (shorter games)
+struct QuickCoupRules : StandardRules {
+    static constexpr const char* NAME = "QuickCoupRules";
+    static constexpr int COUP_COST = 5;
+    static constexpr int FORCED_COUP_COINS = 8;
+};
+
+#ifndef COUP_RULES
+#define COUP_RULES StandardRules
+#endif
+
+using Rules = COUP_RULES; // Rules the engine is built with
+
+}
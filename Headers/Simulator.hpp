@@ -0,0 +1,44 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Action.hpp"
+#include "GameState.hpp"
+#include "Role.hpp"
+#include "RuleTable.hpp"
+
+namespace coup {
+
+// What to simulate
+struct SimConfig {
+    long games = 1000; // Number of games to play
+    int players = 6; // Players per game (2-6)
+    std::vector<RoleId> roles; // Role of each seat (empty for a random role per seat)
+    unsigned threads = 0; // Worker threads (0 for one per core)
+    std::uint64_t seed = 1; // Master seed - the same seed gives the same results with any number of threads
+    int maxTurns = 500; // Games still running after this many actions are counted as unfinished
+    const RuleTable* rules = nullptr; // Rules every game plays by (nullptr for defaultRules()) - shared by all workers, read only
+};
+
+// Aggregated results of a batch of games (each worker fills its own and they are merged at the end)
+struct SimResult {
+    long games = 0; // Games played
+    long unfinished = 0; // Games that hit maxTurns without a winner
+    long totalTurns = 0; // Sum of the game lengths (in actions)
+    long shortestGame = 0; // Length of the shortest finished game (0 if none finished)
+    long longestGame = 0; // Length of the longest finished game
+    long passes = 0; // Turns where the player had no legal move
+    long winsByRole[ROLE_COUNT] = {}; // Wins of each role
+    long seatsByRole[ROLE_COUNT] = {}; // Seats each role played (to turn wins into win rates)
+    long winsBySeat[MAX_PLAYERS] = {}; // Wins of each seat (turn order advantage)
+    long actionCounts[ACTION_COUNT] = {}; // How often each action was played
+    double seconds = 0; // Wall-clock time of the whole batch
+
+    void merge(const SimResult& other); // Adds the counts of another batch
+    double gamesPerSecond() const; // Simulation speed
+};
+
+SimResult runSimulation(const SimConfig& config); // Plays config.games random-move games across the worker threads
+
+}
@@ -7,8 +7,7 @@ namespace coup {
 
 class Spy : public Player {
 public:
-    Spy(Game& game, const std::string& name);
-    std::string role() const override; // Return player's role
+    Spy(Game& game, const std::string& name) : Player(game, name, RoleId::Spy) {} // Blocks arrests (see Player::tryBlockArrest)
 };
 
 }
@@ -0,0 +1,49 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "GameState.hpp"
+
+namespace coup {
+
+// One change to the game state - enough information to revert it
+struct UndoRecord {
+    enum Kind : std::uint8_t { Coins, Flags, Turn, Bribe, LastArrested, LastTurn };
+    Kind kind;
+    Seat seat; // Seat of a Coins / Flags change
+    std::int16_t value; // Coin delta, flipped flag bits, or the previous value of a table field
+};
+
+// Journal of state changes grouped by action, so actions can be taken back in place (make/unmake for tree search).
+// Records are kept in flat buffers that keep their capacity, so after warm-up recording and undoing don't allocate.
+class UndoJournal {
+private:
+    std::vector<UndoRecord> records; // All changes, oldest first
+    std::vector<std::uint32_t> entries; // Index of the first record of each action
+    std::uint32_t scope_start = 0; // First record of the action being recorded
+    int depth = 0; // Nesting depth of open scopes
+    bool enabled = false;
+
+public:
+    // Groups every change made while it is alive into a single undo entry (scopes may nest)
+    class Scope {
+    private:
+        UndoJournal& journal;
+    public:
+        explicit Scope(UndoJournal& journal);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    void setEnabled(bool on); // Starts / stops recording (the journal is cleared)
+    bool isEnabled() const; // Returns whether changes are recorded
+    void clear(); // Drops every entry
+    void record(UndoRecord::Kind kind, Seat seat, int value); // Records a change (its own entry when no scope is open)
+    std::size_t size() const; // Number of entries that can be undone
+    bool undo(GameState& state); // Reverts the newest entry on the state (false if there is none)
+};
+
+}
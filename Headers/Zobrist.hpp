@@ -0,0 +1,84 @@
+// davidkitinberg@gmail.com
+
+#pragma once
+#include <cstdint>
+#include "GameState.hpp"
+
+namespace coup {
+
+// Zobrist hashing of a GameState: the hash is the XOR of one 64-bit key per (feature, value),
+// so a change of one field is folded in by XOR-ing out the old key and XOR-ing in the new one.
+// Keys come from a mixing function instead of a random table (coins have no fixed range).
+// The default value of every field has key 0, so an empty GameState hashes to 0.
+// last_turn is not hashed - it is bookkeeping and does not change what can happen next.
+namespace zobrist {
+
+// Feature tags (top byte of the mixed value) so no two features share a key
+enum Feature : std::uint64_t {
+    COINS = 1,
+    FLAGS = 2,
+    ROLE = 3,
+    SEATS = 4,
+    TURN = 5,
+    BRIBE = 6,
+    ARRESTED = 7,
+};
+
+// splitmix64 finalizer - spreads every input bit over the whole key
+inline std::uint64_t mix(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Key of one (feature, seat, value) triple
+inline std::uint64_t key(Feature feature, Seat seat, std::uint16_t value) {
+    return mix((static_cast<std::uint64_t>(feature) << 56) | (static_cast<std::uint64_t>(seat) << 16) | value);
+}
+
+inline std::uint64_t coins(Seat seat, std::int16_t amount) {
+    return amount == 0 ? 0 : key(COINS, seat, static_cast<std::uint16_t>(amount));
+}
+
+// XOR of the keys of every bit in the mask (a flag flip folds in the keys of the flipped bits)
+inline std::uint64_t flags(Seat seat, std::uint8_t mask) {
+    std::uint64_t h = 0;
+    for (std::uint16_t bit = 0; bit < 8; ++bit) {
+        if (mask & (1u << bit)) h ^= key(FLAGS, seat, bit);
+    }
+    return h;
+}
+
+inline std::uint64_t role(Seat seat, RoleId role) {
+    return role == RoleId{} ? 0 : key(ROLE, seat, static_cast<std::uint16_t>(role));
+}
+
+inline std::uint64_t seats(Seat count) {
+    return count == 0 ? 0 : key(SEATS, 0, count);
+}
+
+inline std::uint64_t turn(Seat seat) {
+    return seat == 0 ? 0 : key(TURN, 0, seat);
+}
+
+inline std::uint64_t bribe(std::uint8_t paid) {
+    return paid == 0 ? 0 : key(BRIBE, 0, 1);
+}
+
+inline std::uint64_t arrested(Seat seat) {
+    return seat == NO_SEAT ? 0 : key(ARRESTED, 0, seat);
+}
+
+// Full recompute of the hash of a state (the incremental hash must always equal this)
+inline std::uint64_t compute(const GameState& state) {
+    std::uint64_t h = seats(state.seat_count) ^ turn(state.current_turn) ^ bribe(state.did_pay_bribe) ^ arrested(state.last_arrested);
+    for (Seat seat = 0; seat < state.seat_count; ++seat) { // Empty seats hash to 0
+        h ^= coins(seat, state.coins[seat]) ^ flags(seat, state.flags[seat]) ^ role(seat, state.roles[seat]);
+    }
+    return h;
+}
+
+}
+
+}
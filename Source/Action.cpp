@@ -0,0 +1,154 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/Action.hpp"
+#include "../Headers/Game.hpp"
+
+
+namespace coup {
+
+namespace {
+
+//////////////////////////////// Generic actions /////////////////////////////
+
+ActionResult doGather(Game&, Player& player, Player*) {
+    return player.tryGather();
+}
+
+ActionResult doTax(Game&, Player& player, Player*) {
+    return player.tryTax();
+}
+
+ActionResult doBribe(Game&, Player& player, Player*) {
+    return player.tryBribe();
+}
+
+ActionResult doArrest(Game&, Player& player, Player* target) {
+    return player.tryArrest(*target);
+}
+
+ActionResult doSanction(Game&, Player& player, Player* target) {
+    return player.trySanction(*target);
+}
+
+ActionResult doCoup(Game&, Player& player, Player* target) {
+    return player.tryCoup(*target);
+}
+
+//////////////////////////////// Special actions /////////////////////////////
+
+ActionResult doInvest(Game&, Player& player, Player*) {
+    return player.tryInvest();
+}
+
+ActionResult doBlockTax(Game&, Player& player, Player* target) {
+    return player.tryBlockTax(*target);
+}
+
+ActionResult doBlockArrest(Game&, Player& player, Player* target) {
+    return player.tryBlockArrest(*target);
+}
+
+ActionResult doBlockCoup(Game&, Player& player, Player* target) {
+    return player.tryPreventCoup(*target);
+}
+
+ActionResult doBlockBribe(Game&, Player& player, Player* target) {
+    return player.tryBlockBribe(*target);
+}
+
+// The action table - indexed directly by ActionId
+const ActionDescriptor ACTION_TABLE[] = {
+    // name        target  ends turn  handler
+    {"Gather",       false,  true,      doGather},
+    {"Tax",          false,  true,      doTax},
+    {"Bribe",        false,  false,     doBribe},
+    {"Arrest",       true,   true,      doArrest},
+    {"Sanction",     true,   true,      doSanction},
+    {"Coup",         true,   true,      doCoup},
+    {"Invest",       false,  true,      doInvest},
+    {"BlockTax",     true,   true,      doBlockTax},
+    {"BlockArrest",  true,   true,      doBlockArrest},
+    {"BlockCoup",    true,   true,      doBlockCoup},
+    {"BlockBribe",   true,   true,      doBlockBribe},
+};
+
+static_assert(sizeof(ACTION_TABLE) / sizeof(ACTION_TABLE[0]) == ACTION_COUNT, "Action table must have one row per ActionId");
+
+}
+
+// Returns the table row of an action (O(1))
+const ActionDescriptor& describe(ActionId action) {
+    return ACTION_TABLE[static_cast<std::size_t>(action)];
+}
+
+// Returns the display name of an action
+const char* actionName(ActionId action) {
+    return describe(action).name;
+}
+
+// Converts a name into an action id (GUI / CLI boundary only)
+bool parseAction(const std::string& name, ActionId& action) {
+    for (std::size_t i = 0; i < ACTION_COUNT; ++i) {
+        if (name == ACTION_TABLE[i].name) {
+            action = static_cast<ActionId>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Builds the text of a result (only when someone needs to show it)
+std::string resultMessage(ActionResult result, ActionId action, const Player& player, const Player* target) {
+    const std::string name = player.getName();
+    const std::string actionText = actionName(action);
+    const std::string targetName = target ? target->getName() : "The target";
+
+    switch (result) {
+        case ActionResult::Ok:
+            return name + " used " + actionText;
+        case ActionResult::InactivePlayer:
+            return "Inactive player cannot play";
+        case ActionResult::NotYourTurn:
+            return "Not your turn";
+        case ActionResult::Sanctioned:
+            return name + " is currently sanctioned and therefore cannot perform " + actionText + ".";
+        case ActionResult::TaxBlocked:
+            return name + " is currently taxed blocked and therefore cannot perform tax.";
+        case ActionResult::ArrestBlocked:
+            return name + " is currently blocked from using arrest (Spy ability).";
+        case ActionResult::BribeBlocked:
+            return name + " is bribe-blocked and cannot use bribe this turn.";
+        case ActionResult::AlreadyBribed:
+            return name + " already used bribe once this turn";
+        case ActionResult::MustCoup:
+            return name + " has " + std::to_string(player.coins()) + " coins (if you have at least " + std::to_string(player.rules().forcedCoupCoins) + " coins you must coup)";
+        case ActionResult::NotEnoughCoins: {
+            int cost = player.rules().cost[static_cast<std::size_t>(action)];
+            if (action == ActionId::Sanction && target) cost += player.rules().sanctionSurcharge[static_cast<std::size_t>(target->roleId())]; // Sanctioning a Judge costs more
+            return name + " cannot perform " + actionText + " (not enough coins - require " + std::to_string(cost) + " coins)";
+        }
+        case ActionResult::TargetNotEnoughCoins:
+            return targetName + " does not have enough coins to lose.";
+        case ActionResult::SelfTarget:
+            return "Cannot perform " + actionText + " on yourself";
+        case ActionResult::TargetEliminated:
+            return "Invalid target: " + targetName + " is already eliminated.";
+        case ActionResult::RecentlyArrested:
+            return targetName + " was recently arrested and cannot be arrested again yet.";
+        case ActionResult::AlreadyOnCoupTrial:
+            return targetName + " is already on coup trial, Please choose someone else";
+        case ActionResult::NotOnCoupTrial:
+            return targetName + " is not on coup trial. Please choose another player";
+        case ActionResult::WrongRole:
+            return actionText + " action only permitted to " + roleName(player.rules().requiredRole(action));
+        case ActionResult::MissingTarget:
+            return actionText + " requires a target.";
+        case ActionResult::UnexpectedTarget:
+            return actionText + " does not take a target.";
+        case ActionResult::UnknownAction:
+            return "Unknown action";
+    }
+    return "Unknown result";
+}
+
+}
@@ -5,40 +5,32 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <random>
 #include "../../Headers/Game.hpp"
 #include "../../Headers/Player.hpp"
 
 using namespace coup;
 
 // Global game objects
-Game game;
+Game game(std::random_device{}()); // A fresh seed every run, so roles differ between runs
 Player* currentPlayer = nullptr;
 
 // Enum for managing UI state
 enum class GUIState { MainMenu, AddPlayer, Game, SelectTarget, WinnerScreen };
 
-// Helper function that matches actions with roles that can block them
-std::vector<std::string> getBlockingRoles(const std::string& action) {
-    if (action == "Tax") return {"Governor"};
-    if (action == "Bribe") return {"Judge"};
-    if (action == "Coup") return {"General"};
-    if (action == "Arrest") return {"Spy"};
-    return {};
-}
-
 // Function for handling real-time action blocking for the matching roles
-bool isActionBlocked(const std::string& action, Player* currentPlayer, Player* targetPlayer,
+bool isActionBlocked(ActionId action, Player* currentPlayer, Player* targetPlayer,
                      const sf::Font& font, std::vector<std::string>& log, Game& game) {
-    std::vector<std::string> blockingRoles = getBlockingRoles(action);
+    RoleId blockingRole = game.rules().blockedBy[static_cast<std::size_t>(action)]; // Role that can block this action (from the rule table)
 
-    for (const auto& role : blockingRoles) 
+    if (blockingRole != RoleId::None) 
     {
-        for (Player* p : game.getPlayers()) 
+        for (Player* p : game.activePlayers()) 
         {
-            if (p == currentPlayer || p->role() != role || !p->isActive()) continue;
+            if (p == currentPlayer || p->roleId() != blockingRole || !p->isActive()) continue;
 
             std::ostringstream title;
-            title << "Player " << currentPlayer->getName() << " is trying to use " << action;
+            title << "Player " << currentPlayer->getName() << " is trying to use " << actionName(action);
             if (targetPlayer != nullptr)
                 title << " on " << targetPlayer->getName();
 
@@ -79,7 +71,7 @@ bool isActionBlocked(const std::string& action, Player* currentPlayer, Player* t
                             if (game.handleBlockConsequences(action, p, currentPlayer, log)) 
                             {
                                 std::ostringstream logMsg;
-                                logMsg << p->getName() << " blocked " << action << " by " << currentPlayer->getName();
+                                logMsg << p->getName() << " blocked " << actionName(action) << " by " << currentPlayer->getName();
                                 if (targetPlayer != nullptr)
                                     logMsg << " targeting " << targetPlayer->getName();
                                 log.push_back(logMsg.str());
@@ -89,7 +81,7 @@ bool isActionBlocked(const std::string& action, Player* currentPlayer, Player* t
                             } 
                             else 
                             {
-                                log.push_back(p->getName() + " tried to block " + action + " but could not afford it.");
+                                log.push_back(p->getName() + " tried to block " + actionName(action) + " but could not afford it.");
                                 blockWindow.close();
                                 return false;  // Failed block — allow next blocker
                             }
@@ -144,10 +136,11 @@ int main() {
     // GUI state management
     GUIState state = GUIState::MainMenu;
     std::string currentInput;
-    std::string pendingAction; // For actions that require a target
+    ActionId pendingAction = ActionId::Gather; // For actions that require a target
     std::vector<std::string> playerNames;
     std::vector<std::string> log; // Game log
     float logScrollOffset = 0; // For scrollable log
+    std::vector<std::size_t> undoMarks; // Undo journal depth before each move (one click may record several entries)
 
     // Text UI Elements
 
@@ -155,6 +148,11 @@ int main() {
     sf::Text spyCoinBtn("Spy Coins", font, 20);
     spyCoinBtn.setFillColor(sf::Color::Red);
 
+    // Undo bottom - takes back the last move
+    sf::Text undoBtn("Undo", font, 20);
+    undoBtn.setFillColor(sf::Color(120, 120, 120));
+    undoBtn.setPosition(530, 100);
+
     // Special action button for role-specific abilities
     sf::Text specialActionBtn("Special", font, 20);
     specialActionBtn.setFillColor(sf::Color::Red);
@@ -211,10 +209,10 @@ int main() {
     winnerText.setPosition(200, 200);
 
     // Action buttons (shown in game state)
-    std::vector<std::string> actionNames = {"Gather", "Tax", "Bribe", "Arrest", "Sanction", "Coup"};
+    std::vector<ActionId> actionIds = {ActionId::Gather, ActionId::Tax, ActionId::Bribe, ActionId::Arrest, ActionId::Sanction, ActionId::Coup};
     std::vector<sf::Text> actionButtons;
-    for (std::size_t i = 0; i < actionNames.size(); ++i) {
-        sf::Text btn(actionNames[i], font, 24);
+    for (std::size_t i = 0; i < actionIds.size(); ++i) {
+        sf::Text btn(actionName(actionIds[i]), font, 24);
         btn.setFillColor(sf::Color(44, 62, 145));
         btn.setPosition(650, 100 + i * 50);
         actionButtons.push_back(btn);
@@ -236,7 +234,8 @@ int main() {
             if (state == GUIState::WinnerScreen && event.type == sf::Event::MouseButtonPressed) {
                 sf::Vector2f mouse(sf::Mouse::getPosition(window));
                 if (newGameBtn.getGlobalBounds().contains(mouse)) {
-                    game = Game();
+                    game = Game(std::random_device{}());
+                    undoMarks.clear();
                     playerNames.clear();
                     log.clear();
                     currentPlayer = nullptr;
@@ -270,29 +269,30 @@ int main() {
 
                 // Handle special action bottom
                 if (state == GUIState::Game && specialActionBtn.getGlobalBounds().contains(mouse)) {
-                    std::string role = currentPlayer->role();
-                    if (role == "Governor") 
+                    RoleId role = currentPlayer->roleId();
+                    if (role == RoleId::Governor) 
                     {
-                        pendingAction = "BlockTax";
+                        pendingAction = ActionId::BlockTax;
                         state = GUIState::SelectTarget;
                     } 
-                    else if (role == "Spy") {
-                        pendingAction = "BlockArrest";
+                    else if (role == RoleId::Spy) {
+                        pendingAction = ActionId::BlockArrest;
                         state = GUIState::SelectTarget;
                     }
-                    else if (role == "General") 
+                    else if (role == RoleId::General) 
                     {
-                        pendingAction = "BlockCoup";
+                        pendingAction = ActionId::BlockCoup;
                         state = GUIState::SelectTarget;
                     } 
-                    else if (role == "Judge") 
+                    else if (role == RoleId::Judge) 
                     {
-                        pendingAction = "BlockBribe";
+                        pendingAction = ActionId::BlockBribe;
                         state = GUIState::SelectTarget;
                     } 
-                    else if (role == "Baron") // Baron has the only special action that is not targetable
+                    else if (role == RoleId::Baron) // Baron has the only special action that is not targetable
                     {
-                        pendingAction = "Invest";
+                        pendingAction = ActionId::Invest;
+                        undoMarks.push_back(game.undoDepth());
                         game.handleTurnWithNoTarget(currentPlayer, pendingAction, log);
                         game.checkElimination(log);
                         currentPlayer = game.turn();
@@ -300,10 +300,24 @@ int main() {
                     }
                 }
 
+                // Handle undo bottom - revert every entry recorded since the last move started
+                if (state == GUIState::Game && !undoMarks.empty() && undoBtn.getGlobalBounds().contains(mouse)) {
+                    // Moves that failed recorded nothing - skip their marks
+                    while (!undoMarks.empty() && undoMarks.back() >= game.undoDepth()) undoMarks.pop_back();
+                    if (!undoMarks.empty()) {
+                        std::size_t mark = undoMarks.back();
+                        undoMarks.pop_back();
+                        while (game.undoDepth() > mark && game.undo()) {}
+                        currentPlayer = game.turn();
+                        log.push_back("Last move was undone.");
+                    }
+                    continue;
+                }
+
                 // Handle special spy coin report bottom
-                if (state == GUIState::Game && currentPlayer->role() == "Spy" && spyCoinBtn.getGlobalBounds().contains(mouse)) {
+                if (state == GUIState::Game && currentPlayer->roleId() == RoleId::Spy && spyCoinBtn.getGlobalBounds().contains(mouse)) {
                     std::ostringstream coinInfo;
-                    for (auto* p : game.getPlayers()) {
+                    for (auto* p : game.activePlayers()) {
                         coinInfo << p->getName() << ": " << p->coins() << " coins\n";
                     }
 
@@ -330,18 +344,19 @@ int main() {
                 if (state == GUIState::MainMenu) // Handle main menu bottoms (add player, start game)
                 {
                     
-                    if (addPlayerBtn.getGlobalBounds().contains(mouse) && game.getPlayers().size() < 6) // Add player button
+                    if (addPlayerBtn.getGlobalBounds().contains(mouse) && game.activeCount() < 6) // Add player button
                     {
                         state = GUIState::AddPlayer;
                         currentInput = "";
                         inputField.setString("");
                     }
                     // Start game button (only if at least 2 players)
-                    if (game.getPlayers().size() >= 2 && startGameBtn.getGlobalBounds().contains(mouse)) 
+                    if (game.activeCount() >= 2 && startGameBtn.getGlobalBounds().contains(mouse)) 
                     {
                         for (const auto& name : playerNames)
                             log.push_back("Added player: " + name);
                         log.push_back("Game started.");
+                        game.enableUndo();
                         currentPlayer = game.turn();
                         state = GUIState::Game;
                     }
@@ -367,20 +382,20 @@ int main() {
 
                     bool cancelFurtherEventHandling = false; // Special flag for coup handling
 
-                    // If a player has at least 10 coins we force him to coup
-                    if (currentPlayer->coins() >= 10) {
+                    // If a player has at least 10 coins (see RuleTable::forcedCoupCoins) we force him to coup
+                    if (currentPlayer->mustCoup()) {
                         // Force player to perform Coup
                         for (std::size_t i = 0; i < actionButtons.size(); ++i) {
                             if (actionButtons[i].getGlobalBounds().contains(mouse)) {
-                                std::string action = actionNames[i];
-                                if (action != "Coup") { // Ignore all non-Coup actions
-                                    log.push_back(currentPlayer->getName() + " has 10 or more coins and must Coup.");
+                                ActionId action = actionIds[i];
+                                if (action != ActionId::Coup) { // Ignore all non-Coup actions
+                                    log.push_back(currentPlayer->getName() + " has " + std::to_string(game.rules().forcedCoupCoins) + " or more coins and must Coup.");
                                     cancelFurtherEventHandling = true;
                                     break;
                                 }
 
                                 // If it's Coup, continue as usual
-                                pendingAction = "Coup";
+                                pendingAction = ActionId::Coup;
                                 state = GUIState::SelectTarget;
                                 break;
                             }
@@ -394,14 +409,15 @@ int main() {
                     // Check if an action button was clicked
                     for (std::size_t i = 0; i < actionButtons.size(); ++i) {
                         if (actionButtons[i].getGlobalBounds().contains(mouse)) {
-                            std::string action = actionNames[i];
+                            ActionId action = actionIds[i];
                             // If action requires target, change state
-                            if (action == "Arrest" || action == "Sanction" || action == "Coup" || action == "BlockBribe" || action == "BlockCoup" || action == "BlockTax") {
+                            if (describe(action).needsTarget) {
                                 pendingAction = action;
                                 state = GUIState::SelectTarget; // Go to select target state
                             } 
                             else // If its a non targetable action
                             {
+                                undoMarks.push_back(game.undoDepth());
                                 if (!isActionBlocked(action, currentPlayer, nullptr, font, log, game)) {
                                         game.handleTurnWithNoTarget(currentPlayer, action, log);
                                         game.checkElimination(log);
@@ -427,11 +443,10 @@ int main() {
                     }
 
                     // Handle target buttons
-                    const auto& players = game.getPlayers();
                     int buttonIndex = 0;
-                    for (size_t i = 0; i < players.size(); ++i) 
+                    for (Player* target : game.activePlayers()) 
                     {
-                        if (players[i] != currentPlayer) 
+                        if (target != currentPlayer) 
                         {
                             float bx = 270.f;
                             float by = 200.f + buttonIndex * 50.f;
@@ -439,8 +454,9 @@ int main() {
                             if (btnRect.contains(mouse)) 
                             {
 
-                                if (!isActionBlocked(pendingAction, currentPlayer, players[i], font, log, game)) {
-                                    game.handleTurnWithTarget(currentPlayer, pendingAction, players[i], log);
+                                undoMarks.push_back(game.undoDepth());
+                                if (!isActionBlocked(pendingAction, currentPlayer, target, font, log, game)) {
+                                    game.handleTurnWithTarget(currentPlayer, pendingAction, target, log);
                                     game.checkElimination(log);
                                 } else {
                                     log.push_back("Action was blocked.");
@@ -448,6 +464,7 @@ int main() {
                                 currentPlayer = game.turn();
                                 game.handleMerchantPassive(currentPlayer, log); // Each turn, the game check for passive Merchant ability
                                 state = GUIState::Game;
+                                break; // The view follows the table - the buttons are laid out again next frame
                             }
                             ++buttonIndex;
                         }
@@ -565,7 +582,7 @@ int main() {
                       << "\nRole: " << currentPlayer->role()
                       << "\nCoins: " << currentPlayer->coins()
                       << "\n\nOther Players:";
-                for (auto* p : game.getPlayers()) {
+                for (auto* p : game.activePlayers()) {
                     if (p != currentPlayer) stats << "\n Player name: " << p->getName() << "\n Player's role: " << p->role();
                 }
                 sf::Text statsText(stats.str(), font, 24);
@@ -588,19 +605,31 @@ int main() {
                 }
             }
 
+            // Draw undo bottom when there is a move to take back
+            if (state == GUIState::Game && !undoMarks.empty())
+            {
+                sf::RectangleShape undoFrame(sf::Vector2f(undoBtn.getGlobalBounds().width + 20, undoBtn.getGlobalBounds().height + 18));
+                undoFrame.setPosition(undoBtn.getPosition().x - 10, undoBtn.getPosition().y - 5);
+                undoFrame.setOutlineColor(sf::Color(120, 120, 120));
+                undoFrame.setOutlineThickness(1);
+                undoFrame.setFillColor(sf::Color::Transparent);
+                window.draw(undoFrame);
+                window.draw(undoBtn);
+            }
+
             // Draw special action bottom for each role
             if (state == GUIState::Game && currentPlayer != nullptr) 
             {
-                std::string role = currentPlayer->role();
+                RoleId role = currentPlayer->roleId();
 
                 specialActionBtn.setString(""); // reset the action bottom each time for the sake of roles with no special actions
 
-                if (role == "Governor") 
+                if (role == RoleId::Governor) 
                 {
                     specialActionBtn.setString("Block Tax");
                     specialActionBtn.setPosition(650, 100 + 6 * 50);
                 } 
-                else if (role == "Spy") 
+                else if (role == RoleId::Spy) 
                 {
                     specialActionBtn.setString("Block Arrest");
                     specialActionBtn.setPosition(650, 100 + 6 * 50);
@@ -614,19 +643,19 @@ int main() {
                     window.draw(spyCoinBtn);
                     
                 } 
-                else if (role == "General") 
+                else if (role == RoleId::General) 
                 {
                     specialActionBtn.setString("Block Coup");
                     specialActionBtn.setPosition(650, 100 + 6 * 50);
                     
                 } 
-                else if (role == "Judge") 
+                else if (role == RoleId::Judge) 
                 {
                     specialActionBtn.setString("Block Bribe");
                     specialActionBtn.setPosition(650, 100 + 6 * 50);
                     
                 } 
-                else if (role == "Baron") 
+                else if (role == RoleId::Baron) 
                 {
                     specialActionBtn.setString("Invest");
                     specialActionBtn.setPosition(650, 100 + 6 * 50);  
@@ -669,14 +698,13 @@ int main() {
                 window.draw(closeX);
 
                 // Player buttons inside modal
-                const auto& players = game.getPlayers();
                 int buttonIndex = 0;
-                for (size_t i = 0; i < players.size(); ++i) 
+                for (Player* target : game.activePlayers()) 
                 {
                 
-                    if (players[i] != currentPlayer) 
+                    if (target != currentPlayer) 
                     {
-                        sf::Text btn(players[i]->getName(), font, 20);
+                        sf::Text btn(target->getName(), font, 20);
                         float bx = 270.f;
                         float by = 200.f + buttonIndex * 50.f;
                         btn.setPosition(bx, by);
@@ -4,315 +4,577 @@
 #include "../Headers/Game.hpp"
 #include "../Headers/PlayerFactory.hpp"
 
+#include <cassert>
+
 namespace coup {
 
 // Empty constructor
-Game::Game() {}
+Game::Game() : Game(0) {}
 
-// Global pointer to the player who made the last turn
-Player* last_turn_player = nullptr;
+// Constructor - every random choice of the table comes from this seed
+Game::Game(std::uint64_t seed) : generator(seed) {}
 
 // Destructor
 Game::~Game() {
-    for (Player* p : player_list) {
-        delete p;
+    destroyPlayers();
+}
+
+// Copy constructor - recreates every player (same seat, role and name) bound to the new game.
+// The copy starts with an empty undo journal and event buffer (recording stays on if it was on).
+Game::Game(const Game& other) : table(other.table), generator(other.generator), rule_table(other.rule_table), rule_variant(other.rule_variant) {
+    journal.setEnabled(other.journal.isEnabled());
+    event_log.setEnabled(other.event_log.isEnabled());
+    Seat built = 0;
+    try {
+        for (; built < table.seat_count; ++built) {
+            const Player* p = other.player_list[built];
+            player_list[built] = createPlayerByRole(p->roleId(), *this, p->name, player_slots[built]);
+            player_list[built]->seat = built;
+        }
+    }
+    catch (...) {
+        while (built > 0) player_list[--built]->~Player();
+        throw;
+    }
+}
+
+// Copy assignment
+Game& Game::operator=(const Game& other) {
+    if (this != &other) {
+        *this = Game(other); // Copy, then move into place
+    }
+    return *this;
+}
+
+// Move constructor - rebuilds the players in this game's slots
+Game::Game(Game&& other) noexcept : table(other.table), journal(std::move(other.journal)), event_log(std::move(other.event_log)), recorder(other.recorder), generator(other.generator), rule_table(other.rule_table), rule_variant(other.rule_variant) {
+    takePlayers(other);
+    other.table = GameState();
+    other.recorder = nullptr;
+}
+
+// Move assignment
+Game& Game::operator=(Game&& other) noexcept {
+    if (this != &other) {
+        destroyPlayers();
+        takePlayers(other);
+        table = other.table;
+        journal = std::move(other.journal);
+        event_log = std::move(other.event_log);
+        recorder = other.recorder;
+        generator = other.generator;
+        rule_table = other.rule_table;
+        rule_variant = other.rule_variant;
+        other.table = GameState();
+        other.recorder = nullptr;
+    }
+    return *this;
+}
+
+// Rebuilds the players of another game in this one and destroys the originals (names are moved, not copied)
+void Game::takePlayers(Game& other) noexcept {
+    for (Seat seat = 0; seat < other.table.seat_count; ++seat) {
+        Player* p = other.player_list[seat];
+        player_list[seat] = createPlayerByRole(p->roleId(), *this, std::string(), player_slots[seat]);
+        player_list[seat]->seat = seat;
+        player_list[seat]->name = std::move(p->name);
+    }
+    other.destroyPlayers();
+}
+
+// Destroys every player in place and frees the seats
+void Game::destroyPlayers() noexcept {
+    for (Seat seat = 0; seat < table.seat_count; ++seat) {
+        if (player_list[seat]) player_list[seat]->~Player();
+        player_list[seat] = nullptr;
     }
-    player_list.clear();
+}
+
+// Returns an independent deep copy of the table (for lookahead)
+Game Game::clone() const {
+    return Game(*this);
+}
+
+// Returns the random generator of the table (clones continue the same stream)
+Rng& Game::random() {
+    return generator;
+}
+
+// Returns the seed the table was created with
+std::uint64_t Game::seed() const {
+    return generator.seed();
+}
+
+// Plays by a rule table from now on (it must outlive the game) - a variant's table plays by its compiled constants
+void Game::setRules(const RuleTable& rules) {
+    const std::size_t variant = variantOf(rules);
+    rule_table = variant < RULE_VARIANT_COUNT ? nullptr : &rules;
+    rule_variant = variant < RULE_VARIANT_COUNT ? static_cast<std::uint8_t>(variant) : 0;
+}
+
+// Returns the rules the game plays by as a table (variantRules() for the compiled ones)
+const RuleTable& Game::rules() const {
+    return rule_table ? *rule_table : variantRules(rule_variant);
+}
+
+// Returns the packed state of the table (cheap to copy)
+const GameState& Game::state() const {
+    return table;
+}
+
+// Returns the Zobrist hash of the table (equal states have equal hashes)
+std::uint64_t Game::hash() const {
+    return table.hash;
+}
+
+// Restores a state taken from this table (same seats and roles)
+void Game::loadState(const GameState& state) {
+    if (state.seat_count != table.seat_count) {
+        throw std::invalid_argument("State belongs to a table with a different number of players");
+    }
+    for (size_t i = 0; i < table.seat_count; ++i) {
+        if (state.roles[i] != table.roles[i]) {
+            throw std::invalid_argument("State belongs to a table with different roles");
+        }
+    }
+    table = state;
+    table.active_seats = seatsWith(table, FLAG_ACTIVE); // Don't trust derived fields that came from outside
+    table.trial_seats = seatsWith(table, FLAG_COUP_TRIAL);
+    table.hash = zobrist::compute(table);
+    journal.clear(); // Recorded changes don't apply to the loaded state
+}
+
+// Starts / stops recording actions (clears the journal)
+void Game::enableUndo(bool enabled) {
+    journal.setEnabled(enabled);
+}
+
+// Reverts the last recorded action (false if there is nothing to undo)
+bool Game::undo() {
+    bool undone = journal.undo(table);
+    verifyHash();
+    return undone;
+}
+
+// Number of recorded actions that can be undone
+std::size_t Game::undoDepth() const {
+    return journal.size();
+}
+
+// Adds coins to a seat (negative to take coins)
+void Game::changeCoins(Seat seat, int delta) {
+    journal.record(UndoRecord::Coins, seat, delta);
+    std::int16_t coins = static_cast<std::int16_t>(table.coins[seat] + delta);
+    table.hash ^= zobrist::coins(seat, table.coins[seat]) ^ zobrist::coins(seat, coins);
+    table.coins[seat] = coins;
+    verifyHash();
+}
+
+// Turns flags of a seat on
+void Game::setFlags(Seat seat, std::uint8_t mask) {
+    std::uint8_t flipped = mask & ~table.flags[seat];
+    if (flipped) journal.record(UndoRecord::Flags, seat, flipped);
+    if (flipped & FLAG_ACTIVE) addSeat(table.active_seats, seat);
+    if (flipped & FLAG_COUP_TRIAL) addSeat(table.trial_seats, seat);
+    table.hash ^= zobrist::flags(seat, flipped);
+    table.flags[seat] |= mask;
+    verifyHash();
+}
+
+// Turns flags of a seat off
+void Game::clearFlags(Seat seat, std::uint8_t mask) {
+    std::uint8_t flipped = mask & table.flags[seat];
+    if (flipped) journal.record(UndoRecord::Flags, seat, flipped);
+    if (flipped & FLAG_ACTIVE) removeSeat(table.active_seats, seat);
+    if (flipped & FLAG_COUP_TRIAL) removeSeat(table.trial_seats, seat);
+    table.hash ^= zobrist::flags(seat, flipped);
+    table.flags[seat] &= ~mask;
+    verifyHash();
+}
+
+// Gives the turn to a seat
+void Game::setTurn(Seat seat) {
+    if (table.current_turn != seat) journal.record(UndoRecord::Turn, 0, table.current_turn);
+    table.hash ^= zobrist::turn(table.current_turn) ^ zobrist::turn(seat);
+    table.current_turn = seat;
+    verifyHash();
+}
+
+// Marks whether the current player paid a bribe this turn
+void Game::setBribe(bool paid) {
+    if ((table.did_pay_bribe != 0) != paid) journal.record(UndoRecord::Bribe, 0, table.did_pay_bribe);
+    std::uint8_t value = paid ? 1 : 0;
+    table.hash ^= zobrist::bribe(table.did_pay_bribe) ^ zobrist::bribe(value);
+    table.did_pay_bribe = value;
+    verifyHash();
+}
+
+// Marks the most recently arrested seat
+void Game::setLastArrested(Seat seat) {
+    if (table.last_arrested != seat) journal.record(UndoRecord::LastArrested, 0, table.last_arrested);
+    table.hash ^= zobrist::arrested(table.last_arrested) ^ zobrist::arrested(seat);
+    table.last_arrested = seat;
+    verifyHash();
+}
+
+// Marks the seat that played the last turn
+void Game::setLastTurn(Seat seat) {
+    if (table.last_turn != seat) journal.record(UndoRecord::LastTurn, 0, table.last_turn);
+    table.last_turn = seat;
+}
+
+// Debug builds check the incremental hash against a full recompute
+void Game::verifyHash() const {
+#ifndef NDEBUG
+    assert(table.hash == zobrist::compute(table) && "incremental Zobrist hash is out of sync with the table");
+#endif
+}
+
+// Gives a newly created player the next free seat
+void Game::seatPlayer(RoleId role, const std::string& name) {
+    Seat seat = table.seat_count;
+    Player* player = createPlayerByRole(role, *this, name, player_slots[seat]); // Factory function (built in place)
+    player->seat = seat;
+    player_list[seat] = player; // Add player to the game
+    table.seat_count++;
+    table.coins[seat] = 0;
+    table.flags[seat] = FLAG_ACTIVE;
+    addSeat(table.active_seats, seat);
+    table.roles[seat] = role;
+    table.hash = zobrist::compute(table); // Setup only - not worth an incremental update
+    journal.clear(); // Recorded changes were made on a different table
 }
 
 // Function to add player with random Role
 void Game::addPlayerWithRandomRole(const std::string& name) {
-    if (player_list.size() >= 6) { // Limit number of players to 6
-        throw std::runtime_error("Maximum 6 players allowed");
+    if (table.seat_count >= MAX_PLAYERS) { // Limit number of players to 6 (COUP_MAX_SEATS)
+        throw std::runtime_error("Maximum " + std::to_string(MAX_PLAYERS) + " players allowed");
     }
-    static std::vector<std::string> roles = {"Baron", "Spy", "Governor", "Merchant", "Judge", "General"};
+    RoleId role = static_cast<RoleId>(generator.below(ROLE_COUNT)); // Assign random role from the table's own generator
 
-    // Use the Mersenne Twister engine for better randomization
-    static std::random_device rd;
-    static std::mt19937 gen(rd()); // seed once the random object
-    std::uniform_int_distribution<> dis(0, roles.size() - 1);
-
-    std::string role = roles[dis(gen)]; // Assign random role
 
+    seatPlayer(role, name);
+}
 
-    Player* player = createPlayerByRole(role, *this, name); // Factory function
-    player_list.push_back(player); // Add player to the game
+// Function that adds player with desired role
+void Game::addPlayerWithRole(const std::string& name, RoleId role) {
+    if (table.seat_count >= MAX_PLAYERS) { // Limit number of players to 6 (COUP_MAX_SEATS)
+        throw std::runtime_error("Maximum " + std::to_string(MAX_PLAYERS) + " players allowed");
+    }
+    seatPlayer(role, name);
 }
 
-// Function that adds player with desired role (only used for testing)
+// Function that adds player with desired role, parses the role name first (only used for testing)
 void Game::addPlayerWithRole(const std::string& name, const std::string& role) {
-    if (player_list.size() >= 6) { // Limit number of players to 6
-        throw std::runtime_error("Maximum 6 players allowed");
-    }
-    Player* player = createPlayerByRole(role, *this, name); // Factory function
-    player_list.push_back(player); // Add player to the game
+    RoleId id;
+    if (!parseRole(role, id)) throw std::invalid_argument("Invalid role: " + role);
+    addPlayerWithRole(name, id);
 }
 
 
-// Function that gives the Players of the game
+// Function that gives the Players of the game (a copy - prefer activePlayers() in loops)
 std::vector<Player*> Game::getPlayers() const {
-    std::vector<Player*> result;
-    for (Player* p : player_list) 
-    {
-        if (p->isActive()) 
-        {
-            result.push_back(p);
-        }
-    }
-    return result;
+    ActivePlayers active = activePlayers();
+    return std::vector<Player*>(active.begin(), active.end());
+}
+
+// Returns the players still in the game, in seat order (a view - nothing is allocated)
+ActivePlayers Game::activePlayers() const {
+    return ActivePlayers(player_list, &table);
+}
+
+// Returns the number of players still in the game
+std::size_t Game::activeCount() const {
+    return seatCount(table.active_seats);
+}
+
+// Returns the player sitting at a seat (also eliminated ones)
+Player* Game::playerAt(std::size_t seat) const {
+    if (seat >= table.seat_count) throw std::out_of_range("No player sits at seat " + std::to_string(seat));
+    return player_list[seat];
 }
 
 // Function that returns the current player that has the turn now
 Player* Game::turn() {
-    if (player_list.empty()) { // Check for empty vector (should not even exist in our game logic)
+    if (table.seat_count == 0) { // Check for empty table (should not even exist in our game logic)
         throw std::runtime_error("No players in the game");
     }
+    UndoJournal::Scope scope(journal); // Eliminations done here belong to the action that triggered them
+
+    // Handle coup trials: every player reached on trial is eliminated and the turn moves on - one pass over the
+    // trial mask, each step lands on the next active seat, so a run of trials costs no extra stack frames
+    while (hasSeat(table.trial_seats, table.current_turn)) {
+        Player* on_trial = player_list[table.current_turn];
+        eliminateOnTrial(on_trial); // Kick player from the game (clears his active and trial bits)
+        endTurnOf(on_trial);        // Skip to the next active seat
+    }
+
+    return player_list[table.current_turn];
+}
+
+// Whether the seat's player may play the action now - his role, coins and flags (targets are checked by canTarget)
+template <typename R>
+inline bool Game::canUse(const R& rules, ActionId action, Seat seat) const noexcept {
+    const std::uint8_t flags = table.flags[seat];
+    const int coins = table.coins[seat];
+    if (!rules.mayUse(table.roles[seat], action)) return false;
+    switch (action) {
+        case ActionId::Gather: return !(flags & FLAG_SANCTIONED);
+        case ActionId::Tax: return !(flags & (FLAG_SANCTIONED | FLAG_TAX_BLOCKED));
+        case ActionId::Bribe: return coins >= rules.cost(action) && !(flags & FLAG_BRIBE_BLOCKED) && !table.did_pay_bribe;
+        case ActionId::Arrest: return !(flags & FLAG_ARREST_BLOCKED);
+        case ActionId::Sanction: // The target's surcharge comes on top (canTarget)
+        case ActionId::Coup:
+        case ActionId::Invest:
+        case ActionId::BlockCoup: return coins >= rules.cost(action);
+        default: return true;
+    }
+}
+
+// Whether an action the seat can use may target another active seat
+template <typename R>
+inline bool Game::canTarget(const R& rules, ActionId action, Seat seat, Seat target) const noexcept {
+    const RoleId targetRole = table.roles[target];
+    switch (action) {
+        // A Merchant pays 2 coins when arrested, everyone else pays 1
+        case ActionId::Arrest: return table.last_arrested != target && table.coins[target] >= rules.arrestLoss(targetRole);
+        // Sanctioning a Judge costs one extra coin
+        case ActionId::Sanction: return table.coins[seat] >= rules.cost(action) + rules.sanctionSurcharge(targetRole);
+        case ActionId::Coup: return !hasSeat(table.trial_seats, target);
+        case ActionId::BlockCoup: return hasSeat(table.trial_seats, target);
+        default: return true;
+    }
+}
+
+// Returns every move the rules allow the player right now (empty if it's not his turn).
+// Mirrors the checks of the actions themselves, so every returned move can be played without throwing.
+// Targets are built as seat masks - word operations on large tables, only Arrest and Sanction look at each target.
+MoveList Game::legalActions(const Player* player) const noexcept {
+    return withRules([&](const auto& rules) { return listMoves(rules, player); });
+}
+
+template <typename R>
+MoveList Game::listMoves(const R& rules, const Player* player) const noexcept {
+    MoveList moves;
+    if (!player || player->game != this) return moves;
+
+    const Seat seat = player->seat;
+    const std::uint8_t flags = table.flags[seat];
+    if (!(flags & FLAG_ACTIVE) || (flags & FLAG_COUP_TRIAL) || table.current_turn != seat) return moves;
+
+    SeatMask others = table.active_seats;
+    removeSeat(others, seat);
+
+    // Forced coup: with 10 coins or more the only move is a coup (see mustCoup)
+    if (mustCoup(rules, seat)) {
+        moves.setTargets(ActionId::Coup, seatsWithout(others, table.trial_seats));
+        return moves;
+    }
+    // Every action is checked by name, so each check folds to a few compares under the built-in rules
+    auto can = [&](ActionId action) { return canUse(rules, action, seat); };
+
+    // Actions without a target
+    if (can(ActionId::Gather)) moves.push(ActionId::Gather);
+    if (can(ActionId::Tax)) moves.push(ActionId::Tax);
+    if (can(ActionId::Bribe)) moves.push(ActionId::Bribe);
+    if (can(ActionId::Invest)) moves.push(ActionId::Invest);
+
+    // Arrest and Sanction depend on each target's coins and role - one pass over the other seats for both
+    const bool arrest = can(ActionId::Arrest), sanction = can(ActionId::Sanction);
+    if (arrest || sanction) {
+        SeatMask arrests{}, sanctions{};
+        for (Seat t = firstSeat(others); t != NO_SEAT; t = seatAfter(others, t)) {
+            if (arrest && canTarget(rules, ActionId::Arrest, seat, t)) addSeat(arrests, t);
+            if (sanction && canTarget(rules, ActionId::Sanction, seat, t)) addSeat(sanctions, t);
+        }
+        moves.setTargets(ActionId::Arrest, arrests);
+        moves.setTargets(ActionId::Sanction, sanctions);
+    }
 
-    Player* p = player_list[current_turn]; // Update current player pointer
+    // The rest are whole seat masks - word operations on large tables
+    if (can(ActionId::Coup)) moves.setTargets(ActionId::Coup, seatsWithout(others, table.trial_seats));
+    // Role specials: Governor, Spy and Judge by default
+    if (can(ActionId::BlockTax)) moves.setTargets(ActionId::BlockTax, others);
+    if (can(ActionId::BlockArrest)) moves.setTargets(ActionId::BlockArrest, others);
+    if (can(ActionId::BlockBribe)) moves.setTargets(ActionId::BlockBribe, others);
+    if (can(ActionId::BlockCoup)) moves.setTargets(ActionId::BlockCoup, commonSeats(others, table.trial_seats));
+    return moves;
+}
+
+// Returns a uniformly random legal move without listing them all: draws from the untargeted moves plus every targeted
+// action the player can use on every active seat, and draws again when the target doesn't qualify. Uniform over the legal
+// moves because every candidate is equally likely; after a few misses (mostly illegal targets) it lists the moves instead.
+Move Game::randomLegalAction(const Player* player, Rng& rng, ActionId only) const noexcept {
+    return withRules([&](const auto& rules) { return drawMove(rules, player, rng, only); });
+}
 
-    // Handle coup trial: eliminate if not blocked
-    if (p->onCoupTrial()) 
-    {
-        p->eliminate();  // Kick player from the game
-        nextTurn();      // skip to next valid player
-        return turn();   // recursively return the next valid player
+template <typename R>
+Move Game::drawMove(const R& rules, const Player* player, Rng& rng, ActionId only) const noexcept {
+    const Move none{ActionId::Count, NO_SEAT};
+    if (!player || player->game != this) return none;
+    const Seat seat = player->seat;
+    const std::uint8_t flags = table.flags[seat];
+    if (!(flags & FLAG_ACTIVE) || (flags & FLAG_COUP_TRIAL) || table.current_turn != seat) return none;
+
+    Move untargeted[MoveList::UNTARGETED_CAPACITY];
+    ActionId targeted[MoveList::TARGETED_ACTIONS];
+    std::uint32_t untargetedCount = 0, targetedCount = 0;
+    const bool forced = mustCoup(rules, seat);
+    auto consider = [&](ActionId action) { // Called once per action by name, like listMoves
+        if ((only != ActionId::Count && action != only) || (forced && action != ActionId::Coup) || !canUse(rules, action, seat)) return;
+        if (MoveList::slotOf(action) < MoveList::TARGETED_ACTIONS) targeted[targetedCount++] = action;
+        else untargeted[untargetedCount++] = Move{action, NO_SEAT};
+    };
+    consider(ActionId::Gather);
+    consider(ActionId::Tax);
+    consider(ActionId::Bribe);
+    consider(ActionId::Invest);
+    consider(ActionId::Arrest);
+    consider(ActionId::Sanction);
+    consider(ActionId::Coup);
+    consider(ActionId::BlockTax);
+    consider(ActionId::BlockArrest);
+    consider(ActionId::BlockCoup);
+    consider(ActionId::BlockBribe);
+
+    const std::uint32_t seats = seatCount(table.active_seats);
+    const std::uint32_t candidates = untargetedCount + targetedCount * seats;
+    if (candidates == 0) return none;
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        std::uint32_t pick = rng.below(candidates);
+        if (pick < untargetedCount) return untargeted[pick];
+        pick -= untargetedCount;
+        const ActionId action = targeted[pick / seats];
+        const Seat target = nthSeat(table.active_seats, pick % seats);
+        if (target != seat && canTarget(rules, action, seat, target)) return Move{action, target};
     }
 
-    return p;
+    MoveList moves = listMoves(rules, player);
+    if (only != ActionId::Count) moves.keepOnly(only);
+    if (moves.empty()) return none;
+    return moves[rng.below(static_cast<std::uint32_t>(moves.size()))];
 }
 
 // Fucntion that return vector list of the current players names (in string)
 std::vector<std::string> Game::players() const {
     std::vector<std::string> result;
-    for (Player* p : player_list) {
-        if (p->isActive()) {
-            result.push_back(p->getName());
-        }
+    result.reserve(seatCount(table.active_seats));
+    for (Player* p : activePlayers()) {
+        result.push_back(p->getName());
     }
     return result;
 }
 
 // Function that declares winner
 Player* Game::winner() const {
-    int count = 0;
-    Player* last_active = nullptr;
+    if (seatCount(table.active_seats) != 1) return nullptr; // No winner yet or more than one player still active
+    return player_list[firstSeat(table.active_seats)]; // Only if one player left in active state we will declare winner
+}
 
-    for (Player* p : player_list) {
-        if (p->isActive()) {
-            last_active = p;
-            count++;
-        }
-    }
+// Seat of a player for an event (NO_SEAT for a missing player)
+static Seat seatOf(const Player* player) {
+    return player ? static_cast<Seat>(player->seatIndex()) : NO_SEAT;
+}
+
+// Runs the handler of an action, reports the outcome and passes the turn when the action ends it
+static ActionResult runAction(ActionId action, Game& game, Player* player, Player* target) {
+    const ActionDescriptor& desc = describe(action);
+    const int playerCoins = player->coins();
+    const int targetCoins = target ? target->coins() : 0;
 
-    if (count == 1) { // Only if one player left in active state we will declare winner
-        return last_active;
+    ActionResult result = desc.handler(game, *player, target);
+    if (result != ActionResult::Ok) {
+        game.events().push(EventKind::ActionFailed, action, result, seatOf(player), seatOf(target));
+        return result;
     }
+    game.events().push(EventKind::ActionPlayed, action, result, seatOf(player), seatOf(target),
+                       player->coins() - playerCoins, target ? target->coins() - targetCoins : 0);
+    if (desc.endsTurn) game.nextTurn();
+    return result;
+}
+
+// Returns the event buffer of the table
+EventLog& Game::events() {
+    return event_log;
+}
 
-    return nullptr; // No winner yet or more than one player still active
+const EventLog& Game::events() const {
+    return event_log;
 }
 
 // Function to handle turn game with action that requires a target
-void Game::handleTurnWithTarget(Player* player, const std::string& action, Player* target, std::vector<std::string>& log) {
+ActionResult Game::handleTurnWithTarget(Player* player, ActionId action, Player* target) {
     if (!player || !target) { // Check null
-        log.push_back("Invalid turn: Player or target is null.");
-        return;
+        ActionResult result = player ? ActionResult::MissingTarget : ActionResult::InactivePlayer;
+        event_log.push(EventKind::ActionRejected, action, result, NO_SEAT); // No seat to report
+        return result;
     }
+    UndoJournal::Scope scope(journal); // The whole action is one undo entry
 
     if (!player->isActive()) { // Check active player
-        log.push_back(player->getName() + " is out of the game.");
-        return;
+        event_log.push(EventKind::ActionRejected, action, ActionResult::InactivePlayer, seatOf(player), seatOf(target));
+        return ActionResult::InactivePlayer;
     }
 
     if (!target->isActive()) { // Check active player (target)
-        log.push_back("Invalid target: " + target->getName() + " is already eliminated.");
-        return;
-    }
-
-    if(player->coins() >= 10) // force Coup if there is more than 10 coins
-    {
-        try {
-            player->coup(*target);
-            log.push_back(player->getName() + " placed " + target->getName() + 
-                    " on a coup trial. On " + target->getName() + "'s next turn, he/she will be eliminated");
-            nextTurn();
-        } 
-        catch (const std::exception& e) {
-            log.push_back("Action failed: " + std::string(e.what()));
-        }
+        event_log.push(EventKind::ActionRejected, action, ActionResult::TargetEliminated, seatOf(player), seatOf(target));
+        return ActionResult::TargetEliminated;
     }
-    else // Handle action logic
-    {
-        
-        if (action == "Arrest") {
-            try {
-                player->arrest(*target);
-                log.push_back(player->getName() + " arrested " + target->getName());
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else if (action == "Sanction") {
-            try {
-                player->sanction(*target);
-                log.push_back(player->getName() + " sanctioned " + target->getName());
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else if (action == "Coup") {
-            try {
-                player->coup(*target);
-                log.push_back(player->getName() + " placed " + target->getName() + 
-                    " on a coup trial. On " + target->getName() + "'s next turn, he/she will be eliminated");
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        ////////////////////////////////Special actions /////////////////////////////
-        else if (action == "BlockTax") {
-            try {
-                player->blockTax(*target);
-                log.push_back(player->getName() + " tax blocked " + target->getName());
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else if (action == "BlockCoup") {
-            try {
-                General* general = dynamic_cast<General*>(player);
-                general->preventCoup(*target);
-                log.push_back(player->getName() + " blocked coup " + target->getName() + " is now saved from elimination");
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else if (action == "BlockBribe") {
-            try {
-                player->blockBribe(*target);
-                log.push_back(player->getName() + " bribe blocked " + target->getName());
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else if (action == "BlockArrest") {
-            try {
-                player->blockArrest(*target);
-                log.push_back(player->getName() + " arrest blocked " + target->getName());
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else {
-            log.push_back("Unknown action: " + action);
-            return;
-        }
+
+    if (withRules([&](const auto& rules) { return mustCoup(rules, player->seat); })) { // force Coup if there is more than 10 coins
+        action = ActionId::Coup;
     }
 
+    if (!coup::describe(action).needsTarget) {
+        event_log.push(EventKind::ActionRejected, action, ActionResult::UnexpectedTarget, seatOf(player), seatOf(target));
+        return ActionResult::UnexpectedTarget;
+    }
+    ActionResult result = runAction(action, *this, player, target);
+    if (result == ActionResult::Ok) record(StepKind::Turn, action, player, target);
+    return result;
 }
 
-
-
-
 // Function to handle turn game with action does not require a target
-void Game::handleTurnWithNoTarget(Player* player, const std::string& action, std::vector<std::string>& log) {
+ActionResult Game::handleTurnWithNoTarget(Player* player, ActionId action) {
+    UndoJournal::Scope scope(journal); // The whole action is one undo entry
 
     if (!player->isActive()) { // Check active player
-        log.push_back(player->getName() + " is out of the game.");
-        return;
-    }
-    
-    if (action == "Tax") {
-            try {
-                player->tax();
-                log.push_back(player->getName() + " used tax ");
-                nextTurn();
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-    }
-    else if (action == "Bribe") {
-        if (!player->onBribe())
-        {
-            try {
-                player->bribe();
-                log.push_back(player->getName() + " used bribe ");
-                
-            } 
-            catch (const std::exception& e) {
-                log.push_back("Action failed: " + std::string(e.what()));
-            }
-        }
-        else log.push_back(player->getName() + " already used bribe once this turn");
-    }
-    else if (action == "Gather") {
-        try {
-            player->gather();
-            log.push_back(player->getName() + " used gather ");
-            nextTurn();
-        } 
-        catch (const std::exception& e) {
-            log.push_back("Action failed: " + std::string(e.what()));
-        }
-    }
-    ////////////////////////////////Special actions /////////////////////////////
-    else if (action == "Invest") {
-        try {
-            Baron* baron = dynamic_cast<Baron*>(player);
-            baron->invest();
-            log.push_back(player->getName() + " used invest ");
-            nextTurn();
-        } 
-        catch (const std::exception& e) {
-            log.push_back("Action failed: " + std::string(e.what()));
-        }
+        event_log.push(EventKind::ActionRejected, action, ActionResult::InactivePlayer, seatOf(player));
+        return ActionResult::InactivePlayer;
     }
-    else {
-        log.push_back("Unknown action: " + action);
-        return;
+
+    if (coup::describe(action).needsTarget) {
+        event_log.push(EventKind::ActionRejected, action, ActionResult::MissingTarget, seatOf(player));
+        return ActionResult::MissingTarget;
     }
+    ActionResult result = runAction(action, *this, player, nullptr);
+    if (result == ActionResult::Ok) record(StepKind::Turn, action, player);
+    return result;
 }
 
 // Special function that handles block consequences logic when its not the blocker's turn
-bool Game::handleBlockConsequences(const std::string& action, Player* blocker, Player* initiator, std::vector<std::string>& log) {
+bool Game::handleBlockConsequences(ActionId action, Player* blocker, Player* initiator) {
+    UndoJournal::Scope scope(journal);
     
-    // The initiator should still lose his coins after Judge's bribe block
-    if (action == "Bribe" && blocker->role() == "Judge") {
-        // Bribe gets blocked — player loses 4 coins
-        if (initiator->coins() >= 4) {
-            initiator->deductCoins(4);
-            log.push_back(initiator->getName() + " loses 4 coins due to blocked Bribe.");
+    // Only the blocking role of the action pays (a General 5 coins for a coup), and the initiator still loses his
+    // coins (4 for a bribe a Judge blocked, 7 for a blocked coup)
+    int blockerPays = 0, initiatorLoses = 0;
+    RoleId blockingRole = RoleId::None;
+    withRules([&](const auto& rules) {
+        blockerPays = rules.blockCost(action);
+        initiatorLoses = rules.blockPenalty(action);
+        blockingRole = rules.blockedBy(action);
+    });
+    if (blocker->roleId() == blockingRole && (blockerPays != 0 || initiatorLoses != 0)) {
+        if (blocker->coins() >= blockerPays && initiator->coins() >= initiatorLoses) {
+            if (blockerPays) blocker->deductCoins(blockerPays);
+            if (initiatorLoses) initiator->deductCoins(initiatorLoses);
+            event_log.push(EventKind::BlockPaid, action, ActionResult::Ok, seatOf(blocker), seatOf(initiator), -blockerPays, -initiatorLoses);
+            record(StepKind::Block, action, blocker, initiator);
             return true;
         } else {
-            log.push_back(initiator->getName() + " tried Bribe but didn't have 4 coins to lose.");
-            return false;
-        }
-    }
-
-    // A General should pay 5 coins in order to block
-    if (action == "Coup" && blocker->role() == "General") {
-        if (blocker->coins() >= 5 && initiator->coins() >= 7) {
-            blocker->deductCoins(5);
-            initiator->deductCoins(7);
-            log.push_back(blocker->getName() + " blocked Coup action and lost 5 coins.");
-            log.push_back(initiator->getName() + "'s coup attempt got blocked and lost 7 coins.");
-            return true;
-        } else {
-            log.push_back(blocker->getName() + " tried to block Coup but lacked 5 coins.");
+            const ActionResult shortOf = blocker->coins() < blockerPays ? ActionResult::NotEnoughCoins : ActionResult::TargetNotEnoughCoins;
+            event_log.push(EventKind::BlockUnpaid, action, shortOf, seatOf(blocker), seatOf(initiator));
             return false;
         }
     }
@@ -321,27 +583,64 @@ bool Game::handleBlockConsequences(const std::string& action, Player* blocker, P
 }
 
 // Small simple function to handle Merchant passive ability
-void Game::handleMerchantPassive(Player* player, std::vector<std::string>& log) {
-    if (player->role() == "Merchant" && player->coins() >= 3) {
-        player->addCoins(1);
-        log.push_back(player->getName() + " (Merchant) gained 1 passive coin for having 3+ coins.");
+void Game::handleMerchantPassive(Player* player) {
+    UndoJournal::Scope scope(journal);
+    const RoleId role = player->roleId();
+    int gain = 0, threshold = 0; // Only the Merchant gains by default
+    withRules([&](const auto& rules) {
+        gain = rules.passiveGain(role);
+        threshold = rules.passiveThreshold(role);
+    });
+    if (gain != 0 && player->coins() >= threshold) {
+        player->addCoins(gain);
+        event_log.push(EventKind::MerchantPassive, ActionId::Count, ActionResult::Ok, seatOf(player), NO_SEAT, gain);
+        record(StepKind::MerchantPassive, ActionId::Gather, player);
     }
 }
 
+// Eliminates a player whose coup trial was not blocked and reports it
+void Game::eliminateOnTrial(Player* player) {
+    player->eliminate();
+    event_log.push(EventKind::Eliminated, ActionId::Coup, ActionResult::Ok, seatOf(player));
+    record(StepKind::Eliminated, ActionId::Gather, player);
+}
+
+// Appends a step to the replay (if recording), then a keyframe when one is due.
+// An elimination is recorded before the turn moves on, so keyframes only follow the other steps.
+void Game::record(StepKind kind, ActionId action, const Player* actor, const Player* target) {
+    if (!recorder) return;
+    recorder->record(kind, action, actor->seat, target ? target->seat : NO_SEAT);
+    if (kind != StepKind::Eliminated && recorder->keyframeDue()) recorder->keyframe(table);
+}
+
+// Starts recording every state-changing call into `writer` (nullptr stops)
+void Game::recordTo(ReplayWriter* writer) {
+    recorder = writer;
+}
+
+// The current player has no legal move - the turn goes to the next player
+void Game::passTurn() {
+    UndoJournal::Scope scope(journal);
+    Player* current = turn();
+    event_log.push(EventKind::Pass, ActionId::Count, ActionResult::Ok, seatOf(current));
+    nextTurn();
+    record(StepKind::Pass, ActionId::Gather, current);
+}
+
 // Function that handles turn cycle, bribe handling and flag reset
 void Game::nextTurn() {
-    if (player_list.empty()) return;
-
-    // Save current player before rotating
-    last_turn_player = turn();
+    if (table.seat_count == 0) return;
+    UndoJournal::Scope scope(journal);
+    endTurnOf(player_list[table.current_turn]); // Current player before rotating
+}
 
-    
+// Rotates the turn away from the player who held it - bribe handling and flag reset
+void Game::endTurnOf(Player* last_turn_player) {
+    setLastTurn(last_turn_player->seat);
 
     // Advance only if bribe wasn't used
-    if (!last_turn_player->onBribe()) {
-        do {
-            current_turn = (current_turn + 1) % player_list.size();
-        } while (!player_list[current_turn]->isActive());
+    if (!last_turn_player->onBribe() && seatCount(table.active_seats) != 0) {
+        setTurn(nextSeat(table.active_seats, table.current_turn)); // Next active seat, wrapping around the table
     }
 
     // Reset bribe state of the **previous** player
@@ -354,15 +653,117 @@ void Game::nextTurn() {
 }
 
 // Function that checks elimination before each player's turn and eliminates if there is a need to
-void Game::checkElimination(std::vector<std::string>& log) {
-    Player* p = player_list[current_turn];
-
+void Game::checkElimination() {
+    UndoJournal::Scope scope(journal);
     // Handle coup trial resolution: eliminate if not blocked
-    if (p->onCoupTrial()) {
-        p->eliminate();  // new function below
-        log.push_back(p->getName() + " was eliminated due to an unresolved coup.");
+    if (hasSeat(table.trial_seats, table.current_turn)) {
+        eliminateOnTrial(player_list[table.current_turn]);
         nextTurn();
     }
 }
 
+//////////////////////////////// Text log entry points /////////////////////////////
+
+// Starts collecting the events of one string-log call (turns events on if they were off)
+std::size_t Game::beginText(bool& wasEnabled) {
+    wasEnabled = event_log.isEnabled();
+    event_log.setEnabled(true);
+    return event_log.size();
+}
+
+// Renders the events of the call into the text log (and drops them again if events were off)
+void Game::endText(std::size_t mark, bool wasEnabled, std::vector<std::string>& log) {
+    for (std::size_t i = mark; i < event_log.size(); ++i) {
+        std::string text = renderEvent(*this, event_log[i]);
+        std::size_t start = 0, end;
+        while ((end = text.find('\n', start)) != std::string::npos) { // One log entry per line
+            log.push_back(text.substr(start, end - start));
+            start = end + 1;
+        }
+        log.push_back(text.substr(start));
+    }
+    if (!wasEnabled) {
+        event_log.truncate(mark);
+        event_log.setEnabled(false);
+    }
+}
+
+// Handles a turn with a target and appends its log lines
+ActionResult Game::handleTurnWithTarget(Player* player, ActionId action, Player* target, std::vector<std::string>& log) {
+    bool wasEnabled;
+    std::size_t mark = beginText(wasEnabled);
+    ActionResult result = handleTurnWithTarget(player, action, target);
+    endText(mark, wasEnabled, log);
+    return result;
+}
+
+// Handles a turn without a target and appends its log lines
+ActionResult Game::handleTurnWithNoTarget(Player* player, ActionId action, std::vector<std::string>& log) {
+    bool wasEnabled;
+    std::size_t mark = beginText(wasEnabled);
+    ActionResult result = handleTurnWithNoTarget(player, action);
+    endText(mark, wasEnabled, log);
+    return result;
+}
+
+// Parses the action name and handles a turn with a target
+ActionResult Game::handleTurnWithTarget(Player* player, const std::string& action, Player* target, std::vector<std::string>& log) {
+    ActionId id;
+    if (!parseAction(action, id)) {
+        log.push_back("Unknown action: " + action);
+        return ActionResult::UnknownAction;
+    }
+    return handleTurnWithTarget(player, id, target, log);
+}
+
+// Parses the action name and handles a turn without a target
+ActionResult Game::handleTurnWithNoTarget(Player* player, const std::string& action, std::vector<std::string>& log) {
+    ActionId id;
+    if (!parseAction(action, id)) {
+        log.push_back("Unknown action: " + action);
+        return ActionResult::UnknownAction;
+    }
+    return handleTurnWithNoTarget(player, id, log);
+}
+
+// Handles block consequences and appends their log lines
+bool Game::handleBlockConsequences(ActionId action, Player* blocker, Player* initiator, std::vector<std::string>& log) {
+    bool wasEnabled;
+    std::size_t mark = beginText(wasEnabled);
+    bool allowed = handleBlockConsequences(action, blocker, initiator);
+    endText(mark, wasEnabled, log);
+    return allowed;
+}
+
+// Parses the action name and handles block consequences
+bool Game::handleBlockConsequences(const std::string& action, Player* blocker, Player* initiator, std::vector<std::string>& log) {
+    ActionId id;
+    if (!parseAction(action, id)) return true; // Unknown actions have no block consequences
+    return handleBlockConsequences(id, blocker, initiator, log);
+}
+
+// Handles the Merchant passive ability and appends its log line
+void Game::handleMerchantPassive(Player* player, std::vector<std::string>& log) {
+    bool wasEnabled;
+    std::size_t mark = beginText(wasEnabled);
+    handleMerchantPassive(player);
+    endText(mark, wasEnabled, log);
+}
+
+// Checks elimination and appends its log line
+void Game::checkElimination(std::vector<std::string>& log) {
+    bool wasEnabled;
+    std::size_t mark = beginText(wasEnabled);
+    checkElimination();
+    endText(mark, wasEnabled, log);
+}
+
+// Passes the turn and appends its log line
+void Game::passTurn(std::vector<std::string>& log) {
+    bool wasEnabled;
+    std::size_t mark = beginText(wasEnabled);
+    passTurn();
+    endText(mark, wasEnabled, log);
+}
+
 }
@@ -0,0 +1,82 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/GameEvent.hpp"
+#include "../Headers/Game.hpp"
+
+namespace coup {
+
+// Log line of a successful action
+static std::string renderPlayed(const std::string& actor, ActionId action, const std::string& target) {
+    switch (action) {
+        case ActionId::Gather: return actor + " used gather ";
+        case ActionId::Tax: return actor + " used tax ";
+        case ActionId::Bribe: return actor + " used bribe ";
+        case ActionId::Arrest: return actor + " arrested " + target;
+        case ActionId::Sanction: return actor + " sanctioned " + target;
+        case ActionId::Coup: return actor + " placed " + target + " on a coup trial. On " + target +
+                                    "'s next turn, he/she will be eliminated";
+        case ActionId::Invest: return actor + " used invest ";
+        case ActionId::BlockTax: return actor + " tax blocked " + target;
+        case ActionId::BlockArrest: return actor + " arrest blocked " + target;
+        case ActionId::BlockCoup: return actor + " blocked coup " + target + " is now saved from elimination";
+        case ActionId::BlockBribe: return actor + " bribe blocked " + target;
+        default: return actor + " used " + actionName(action);
+    }
+}
+
+// Name of an action inside a sentence ("coup attempt")
+static std::string lowerName(ActionId action) {
+    std::string name = actionName(action);
+    if (!name.empty() && name[0] >= 'A' && name[0] <= 'Z') name[0] = static_cast<char>(name[0] - 'A' + 'a');
+    return name;
+}
+
+// Builds the log line of an event (a paid Coup block gives two lines, separated by '\n')
+std::string renderEvent(const Game& game, const GameEvent& event) {
+    const std::string actor = event.actor != NO_SEAT ? game.playerAt(event.actor)->getName() : std::string();
+    const std::string target = event.target != NO_SEAT ? game.playerAt(event.target)->getName() : std::string();
+
+    switch (event.kind) {
+        case EventKind::ActionPlayed:
+            return renderPlayed(actor, event.action, target);
+        case EventKind::ActionFailed:
+            return "Action failed: " + resultMessage(event.result, event.action,
+                                                     *game.playerAt(event.actor),
+                                                     event.target != NO_SEAT ? game.playerAt(event.target) : nullptr);
+        case EventKind::ActionRejected:
+            if (event.actor == NO_SEAT) return "Invalid turn: Player or target is null.";
+            if (event.result == ActionResult::InactivePlayer) return actor + " is out of the game.";
+            return resultMessage(event.result, event.action, *game.playerAt(event.actor),
+                                 event.target != NO_SEAT ? game.playerAt(event.target) : nullptr);
+        case EventKind::BlockPaid: { // A line for the blocker's price and one for the initiator's loss (either may be 0)
+            const std::string name = actionName(event.action);
+            std::string text;
+            if (event.actorCoins != 0) text = actor + " blocked " + name + " action and lost " + std::to_string(-event.actorCoins) + " coins.";
+            if (event.targetCoins != 0) {
+                if (!text.empty()) text += "\n" + target + "'s " + lowerName(event.action) + " attempt got blocked and lost " + std::to_string(-event.targetCoins) + " coins.";
+                else text = target + " loses " + std::to_string(-event.targetCoins) + " coins due to blocked " + name + ".";
+            }
+            return text;
+        }
+        case EventKind::BlockUnpaid: { // result says who was short: NotEnoughCoins the blocker, TargetNotEnoughCoins the initiator
+            const std::size_t a = static_cast<std::size_t>(event.action);
+            if (event.result == ActionResult::TargetNotEnoughCoins) {
+                return target + " tried " + actionName(event.action) + " but didn't have " + std::to_string(game.rules().blockPenalty[a]) + " coins to lose.";
+            }
+            return actor + " tried to block " + actionName(event.action) + " but lacked " + std::to_string(game.rules().blockCost[a]) + " coins.";
+        }
+        case EventKind::MerchantPassive: {
+            const RoleId role = game.playerAt(event.actor)->roleId();
+            return actor + " (" + roleName(role) + ") gained " + std::to_string(event.actorCoins) +
+                   (event.actorCoins == 1 ? " passive coin" : " passive coins") + " for having " +
+                   std::to_string(game.rules().passiveThreshold[static_cast<std::size_t>(role)]) + "+ coins.";
+        }
+        case EventKind::Eliminated:
+            return actor + " was eliminated due to an unresolved coup.";
+        case EventKind::Pass:
+            return actor + " has no legal move and passes the turn.";
+    }
+    return std::string();
+}
+
+}
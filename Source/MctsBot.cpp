@@ -0,0 +1,210 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/MctsBot.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace coup {
+
+// Engine speed: playouts per second of the last search
+double MctsStats::playoutsPerSecond() const {
+    return milliseconds > 0 ? playouts * 1000.0 / milliseconds : 0;
+}
+
+// Constructor
+MctsBot::MctsBot(const MctsConfig& config) : settings(config) {
+    if (settings.iterations <= 0 && settings.timeLimitMs <= 0) {
+        throw std::invalid_argument("MCTS bot needs an iteration or a time budget");
+    }
+}
+
+// Returns what the last search did
+const MctsStats& MctsBot::lastStats() const {
+    return stats;
+}
+
+// Returns the search budget and tuning
+const MctsConfig& MctsBot::config() const {
+    return settings;
+}
+
+// Legal moves of a player (PASS when there are none)
+MoveList MctsBot::movesOf(Game& game, Player* player) {
+    MoveList moves = game.legalActions(player);
+    if (moves.empty()) moves.push(PASS);
+    return moves;
+}
+
+// Draws the order the node's moves are expanded in: a random start and a random step coprime to the number of moves
+void MctsBot::startExpansion(Node& node, std::uint32_t moveCount, Rng& rng) {
+    node.moveCount = moveCount;
+    node.tried = 0;
+    node.offset = moveCount > 1 ? rng.below(moveCount) : 0;
+    node.stride = moveCount > 2 ? 1 + rng.below(moveCount - 1) : 1;
+    while (std::gcd(node.stride, moveCount) != 1) ++node.stride;
+    node.expanded = true;
+}
+
+// Plays a move on the simulated table
+void MctsBot::apply(Game& game, Player* player, const Move& move) {
+    if (move.action == PASS) {
+        game.passTurn();
+    } else if (move.target == NO_SEAT) {
+        game.handleTurnWithNoTarget(player, move.action);
+    } else {
+        game.handleTurnWithTarget(player, move.action, game.playerAt(move.target));
+    }
+}
+
+// UCT choice among the expanded children
+std::int32_t MctsBot::selectChild(std::int32_t node) const {
+    const double logVisits = std::log(static_cast<double>(nodes[node].visits));
+    std::int32_t best = -1;
+    double bestScore = -std::numeric_limits<double>::infinity();
+    for (std::int32_t c = nodes[node].firstChild; c != -1; c = nodes[c].nextSibling) {
+        const Node& child = nodes[c];
+        double score = child.reward / child.visits + settings.exploration * std::sqrt(logVisits / child.visits);
+        if (score > bestScore) {
+            bestScore = score;
+            best = c;
+        }
+    }
+    return best;
+}
+
+// Move of the rollout policy - a random coup when there is one (heuristic), otherwise a random move
+Move MctsBot::rolloutMove(Game& game, Player* player) const {
+    if (settings.heuristicRollouts) {
+        const Move coup = game.randomLegalAction(player, game.random(), ActionId::Coup);
+        if (coup.action != ActionId::Count) return coup;
+    }
+    return game.randomLegalAction(player, game.random()); // ActionId::Count (PASS) when there is no move
+}
+
+// Plays the game out and scores it for every seat (1 for the winner, a share of 1 for each player left on a draw)
+void MctsBot::rollout(Game& game, double reward[MAX_PLAYERS]) {
+    for (int turn = 0; turn < settings.maxRolloutTurns; ++turn) {
+        Player* current = game.turn();
+        if (Player* winner = game.winner()) {
+            reward[winner->seatIndex()] = 1;
+            return;
+        }
+        apply(game, current, rolloutMove(game, current));
+    }
+
+    const GameState& state = game.state();
+    int left = 0;
+    for (Seat seat = 0; seat < state.seat_count; ++seat) left += (state.flags[seat] & FLAG_ACTIVE) != 0;
+    for (Seat seat = 0; seat < state.seat_count; ++seat) {
+        if (state.flags[seat] & FLAG_ACTIVE) reward[seat] = 1.0 / left;
+    }
+}
+
+// Searches and returns the best move for the player whose turn it is.
+// The search runs on a clone that continues the game's random stream, and the game picks the stream up where the search left it.
+Move MctsBot::chooseMove(Game& game) {
+    const auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start]() {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    stats = MctsStats();
+
+    Game sim = game.clone();
+    sim.events().setEnabled(false); // Simulated moves are never shown
+    sim.enableUndo();
+    Player* me = sim.turn();
+    const std::size_t rootDepth = sim.undoDepth();
+
+    nodes.clear();
+    if (settings.iterations > 0) nodes.reserve(settings.iterations + 1);
+    nodes.emplace_back(Move{PASS, NO_SEAT}, static_cast<Seat>(me->seatIndex()), -1);
+    const MoveList rootMoves = movesOf(sim, me);
+
+    // Only one move - nothing to search (and nothing drawn from the generator)
+    if (rootMoves.size() == 1) {
+        stats.milliseconds = elapsedMs();
+        return rootMoves[0];
+    }
+    startExpansion(nodes[0], static_cast<std::uint32_t>(rootMoves.size()), sim.random());
+
+    for (long i = 0; settings.iterations <= 0 || i < settings.iterations; ++i) {
+        if (settings.timeLimitMs > 0 && (i & 15) == 0 && elapsedMs() >= settings.timeLimitMs) break;
+
+        // Selection: walk down the expanded part of the tree, then expand one new move
+        std::int32_t node = 0;
+        bool terminal = false;
+        while (true) {
+            Player* current = sim.turn();
+            if (sim.winner()) {
+                terminal = true;
+                break;
+            }
+            if (!nodes[node].expanded || nodes[node].tried < nodes[node].moveCount) {
+                // The moves are listed again on each expansion instead of being kept in the node
+                const MoveList moves = node == 0 ? rootMoves : movesOf(sim, current);
+                Node& parent = nodes[node];
+                if (!parent.expanded) startExpansion(parent, static_cast<std::uint32_t>(moves.size()), sim.random());
+                const std::uint64_t index = (parent.offset + static_cast<std::uint64_t>(parent.tried) * parent.stride) % parent.moveCount;
+                ++parent.tried;
+                const Move move = moves[index];
+                apply(sim, current, move);
+
+                std::int32_t child = static_cast<std::int32_t>(nodes.size());
+                nodes.emplace_back(move, static_cast<Seat>(current->seatIndex()), node);
+                nodes[child].nextSibling = nodes[node].firstChild;
+                nodes[node].firstChild = child;
+                node = child;
+                break;
+            }
+            node = selectChild(node);
+            apply(sim, current, nodes[node].move);
+        }
+
+        // Simulation
+        double reward[MAX_PLAYERS] = {};
+        if (terminal) {
+            reward[sim.winner()->seatIndex()] = 1;
+        } else {
+            rollout(sim, reward);
+        }
+
+        // Backpropagation: every node is scored for the seat that chose its move
+        for (std::int32_t n = node; n != -1; n = nodes[n].parent) {
+            nodes[n].visits++;
+            nodes[n].reward += reward[nodes[n].mover];
+        }
+
+        // Unmake everything the playout did
+        while (sim.undoDepth() > rootDepth && sim.undo()) {}
+        ++stats.playouts;
+    }
+    stats.milliseconds = elapsedMs();
+    game.random() = sim.random();
+
+    // The most visited move is the most robust choice
+    std::int32_t best = -1;
+    for (std::int32_t c = nodes[0].firstChild; c != -1; c = nodes[c].nextSibling) {
+        if (best == -1 || nodes[c].visits > nodes[best].visits) best = c;
+    }
+    return best == -1 ? rootMoves[0] : nodes[best].move;
+}
+
+// Chooses a move for the current player and plays it
+ActionResult MctsBot::playTurn(Game& game, std::vector<std::string>& log) {
+    Player* current = game.turn();
+    Move move = chooseMove(game);
+    if (move.action == PASS) {
+        game.passTurn(log);
+        return ActionResult::Ok;
+    }
+    if (move.target == NO_SEAT) {
+        return game.handleTurnWithNoTarget(current, move.action, log);
+    }
+    return game.handleTurnWithTarget(current, move.action, game.playerAt(move.target), log);
+}
+
+}
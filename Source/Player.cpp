@@ -8,7 +8,7 @@
 
 namespace coup {
 
-Player::Player(Game& g, const std::string& name) : game(g), name(name) {
+Player::Player(Game& g, const std::string& name, RoleId role) : game(&g), table(&g.table), name(name), role_id(role) {
     
 }
 
@@ -17,222 +17,268 @@ std::string Player::getName() const {
     return name;
 }
 
-// Returns number of coins the player has
-int Player::coins() const {
-    return coin_count;
+// Returns the rules of the player's game as a table
+const RuleTable& Player::rules() const {
+    return game->rules();
 }
 
-// Returns the state of player
-bool Player::isActive() const {
-    return state.active;
+// Returns the role name of the player (display only)
+std::string Player::role() const {
+    return roleName(role_id);
 }
 
 // Adds coins to the player
 void Player::addCoins(int amount) {
-    coin_count += amount;
+    game->changeCoins(seat, amount);
 }
 
 // Deducts coins from the player
 void Player::deductCoins(int amount) {
-    if (coin_count < amount) {
+    if (coins() < amount) {
         throw std::runtime_error("Not enough coins");
     }
-    coin_count -= amount;
+    game->changeCoins(seat, -amount);
 }
 
 // Place a player on coup trial (on his next turn he will be terminated), Only a General can undo it
 void Player::deactivate() {
-    state.onCoupTrial = true;
+    game->setFlags(seat, FLAG_COUP_TRIAL);
 }
 
 // Function that eliminates a player that reached his turn in a on coup trial state
 void Player::eliminate() {
-    state.active = false;
-    state.onCoupTrial = false;
+    game->clearFlags(seat, FLAG_ACTIVE | FLAG_COUP_TRIAL);
 }
 
 // Function for the action "Gather" that gives the player 1 coin
 void Player::gather() {
-    validateAction("Gather");
- 
-    addCoins(1);
-    // advance turn should happen in game
+    throwIfFailed(tryGather(), ActionId::Gather);
+}
+
+ActionResult Player::tryGather() {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Gather);
+        if (result != ActionResult::Ok) return result;
+
+        addCoins(rules.gatherGain());
+        // advance turn should happen in game
+        return ActionResult::Ok;
+    });
 }
 
 // Function for the action "Tax" that gives the player 2 coins 
 void Player::tax() {
-    validateAction("Tax");
-    if(onSanctioned()) {
-        throw std::runtime_error(name + " is currently sanctioned and therefore cannot perform tax.");
-    }
-    if(onTaxBlocked()) {
-        throw std::runtime_error(name + " is currently taxed blocked and therefore cannot perform tax.");
-    }
-    else {
-        addCoins(2);
-    }
-    
+    throwIfFailed(tryTax(), ActionId::Tax);
 }
 
-// Function for the action "Bribe" that gives the player another turn
-void Player::bribe() {
-    validateAction("Bribe");
+ActionResult Player::tryTax() {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Tax);
+        if (result != ActionResult::Ok) return result;
+        if (onTaxBlocked()) return ActionResult::TaxBlocked;
 
-    // Check if the player is bribe blocked
-    if (state.isBribeBlocked) {
-        throw std::runtime_error(name + " is bribe-blocked and cannot use bribe this turn.");
-    }
+        addCoins(rules.taxGain(role_id)); // A Governor gets more
+        return ActionResult::Ok;
+    });
+}
 
-    if (coin_count < 4) // Check if the player has enough coins for bribe
-        throw std::runtime_error(name + " cannot perform bribe (not enough coins - require 4 coins)");
-    else {
-        deductCoins(4);
+// Function for the action "Bribe" that gives the player another turn
+void Player::bribe() {
+    throwIfFailed(tryBribe(), ActionId::Bribe);
+}
 
-        state.bribedThisTurn = true;
-    }
+ActionResult Player::tryBribe() {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Bribe);
+        if (result != ActionResult::Ok) return result;
+        if (game->table.flags[seat] & FLAG_BRIBE_BLOCKED) return ActionResult::BribeBlocked; // Check if the player is bribe blocked
+        if (onBribe()) return ActionResult::AlreadyBribed; // Only one bribe per turn
+        const int cost = rules.cost(ActionId::Bribe);
+        if (coins() < cost) return ActionResult::NotEnoughCoins; // Check if the player has enough coins for bribe
+
+        deductCoins(cost);
+        game->setBribe(true);
+        return ActionResult::Ok;
+    });
 }
 
 // Function for the action "Arrest" that steals one coin from a target player and gives the caller 1 coin
 void Player::arrest(Player& target) {
-    validateAction("Arrest");
-
-    if (&target == this) // Check self targeting
-        throw std::runtime_error("Cannot perform arrest on yourself");
-
-    if (target.state.isRecentlyArrested) // Cant arrest twice on a row
-        throw std::runtime_error(target.getName() + " was recently arrested and cannot be arrested again yet.");
-
-
-    // Do the arrest logic
-    target.deductCoins(1);
-    addCoins(1);
-
-    if (target.role() == "General") {
-        target.addCoins(1);
-    }
-    if (target.role() == "Merchant") {
-        target.deductCoins(1);
-        deductCoins(1);
-    }
-
-    // Clear "recently arrested" state from all other players
-    for (Player* p : game.getPlayers()) {
-        if (p != &target) {
-            p->state.isRecentlyArrested = false;
-        }
-    }
+    throwIfFailed(tryArrest(target), ActionId::Arrest, &target);
+}
 
-    // Then mark the target as newly arrested
-    target.state.isRecentlyArrested = true;
+ActionResult Player::tryArrest(Player& target) {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Arrest);
+        if (result != ActionResult::Ok) return result;
+        if (&target == this) return ActionResult::SelfTarget; // Check self targeting
+        if (!target.isActive()) return ActionResult::TargetEliminated;
+        if (game->table.last_arrested == target.seat) return ActionResult::RecentlyArrested; // Cant arrest twice on a row
+        const RoleId targetRole = target.role_id;
+        if (target.coins() < rules.arrestLoss(targetRole)) return ActionResult::TargetNotEnoughCoins; // A Merchant pays 2 coins
+
+        // Do the arrest logic - the target pays, the arrester gets his share (none from a Merchant), a General gets his coin back
+        target.deductCoins(rules.arrestLoss(targetRole));
+        if (rules.arrestGain(targetRole)) addCoins(rules.arrestGain(targetRole));
+        if (rules.arrestRefund(targetRole)) target.addCoins(rules.arrestRefund(targetRole));
+
+        // Mark the target as newly arrested (this clears the mark from the previous one)
+        game->setLastArrested(target.seat);
+        return ActionResult::Ok;
+    });
 }
 
 // Function for the action "Sanction" that blocks the targeted player from using Tax & Gather (costs 3 coins to the caller)
 void Player::sanction(Player& target) {
-    validateAction("Sanction");
-    if (&target == this)
-        throw std::runtime_error("Cannot perform sanctions on yourself");
-    if (coin_count < 3)
-        throw std::runtime_error("Not enough coins for sanctions (require 3 coins)");
-    if ((target.role() == "Judge") && coin_count < 4)
-        throw std::runtime_error("Not enough coins for sanctions on Judge (require 4 coins)");
-    else
-    {
-        deductCoins(3);
-        target.state.isSanctioned = true;
-        if(target.role() == "Baron") target.addCoins(1); // Special Baron compensation
-        if(target.role() == "Judge") deductCoins(1);; // Sanctioning Judge costs 4 coins instead of 3
-    }
+    throwIfFailed(trySanction(target), ActionId::Sanction, &target);
 }
 
-
-// Helper function to see sanction state
-bool Player::onSanctioned() const {
-    return state.isSanctioned;
+ActionResult Player::trySanction(Player& target) {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Sanction);
+        if (result != ActionResult::Ok) return result;
+        if (&target == this) return ActionResult::SelfTarget;
+        if (!target.isActive()) return ActionResult::TargetEliminated;
+        const RoleId targetRole = target.role_id;
+        const int cost = rules.cost(ActionId::Sanction) + rules.sanctionSurcharge(targetRole); // Sanctioning a Judge costs extra
+        if (coins() < cost) return ActionResult::NotEnoughCoins;
+
+        deductCoins(cost);
+        game->setFlags(target.seat, FLAG_SANCTIONED);
+        if (rules.sanctionRefund(targetRole)) target.addCoins(rules.sanctionRefund(targetRole)); // Special Baron compensation
+        return ActionResult::Ok;
+    });
 }
 
 
 // Function for the action "Coup" that places the targeted player on "coup trial" (costs 7 coins to the caller)
 void Player::coup(Player& target) {
-    validateAction("Coup");
-    if (target.onCoupTrial()) throw std::runtime_error(target.getName() + " is already on coup trial, Please choose someone else");
-    if (&target == this) throw std::runtime_error("Cannot perform coup on yourself");
-    if (coin_count < 7) throw std::runtime_error("Not enough coins to coup (require 7 coins)");
-    deductCoins(7);
-    target.deactivate();
+    throwIfFailed(tryCoup(target), ActionId::Coup, &target);
 }
 
+ActionResult Player::tryCoup(Player& target) {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Coup);
+        if (result != ActionResult::Ok) return result;
+        if (target.onCoupTrial()) return ActionResult::AlreadyOnCoupTrial;
+        if (&target == this) return ActionResult::SelfTarget;
+        if (!target.isActive()) return ActionResult::TargetEliminated;
+        const int cost = rules.cost(ActionId::Coup);
+        if (coins() < cost) return ActionResult::NotEnoughCoins;
+
+        deductCoins(cost);
+        target.deactivate();
+        return ActionResult::Ok;
+    });
+}
 
-// Helper method to validate action and save duplicated code
-void Player::validateAction(const std::string& actionName) const {
-    if (!isActive()) {
-        throw std::runtime_error("Inactive player cannot play");
-    }
 
-    if (game.turn() != this) {
-        throw std::runtime_error("Not your turn");
-    }
+// Helper method to validate action and save duplicated code (turn, sanction, arrest block, forced coup)
+template <typename R>
+ActionResult Player::checkAction(const R& rules, ActionId action) const {
+    if (!rules.mayUse(role_id, action)) return ActionResult::WrongRole;
+    if (!isActive()) return ActionResult::InactivePlayer;
 
-    if (onSanctioned() && (actionName == "Tax" || actionName == "Gather")) {
-        throw std::runtime_error(name + " is currently sanctioned and therefore cannot perform " + actionName + ".");
-    }
+    // A player on coup trial is eliminated when his turn comes, so he never gets to act
+    if (game->table.current_turn != seat || onCoupTrial()) return ActionResult::NotYourTurn;
 
-    if (state.isArrestedBlocked && actionName == "Arrest") {
-        throw std::runtime_error(name + " is currently blocked from using arrest (Spy ability).");
-    }
-    if (coin_count >= 10 && actionName != "Coup") throw std::runtime_error(name + " has " + std::to_string(coin_count) + " coins (if you have at least 10 coins you must coup)");
+    if (onSanctioned() && (action == ActionId::Tax || action == ActionId::Gather)) return ActionResult::Sanctioned;
+
+    if (onArrestedBlocked() && action == ActionId::Arrest) return ActionResult::ArrestBlocked;
+
+    if (action != ActionId::Coup && game->mustCoup(rules, seat)) return ActionResult::MustCoup;
+    return ActionResult::Ok;
+}
+
+// Whether the player is forced to coup this turn (enough coins for the forced coup, and he can pay for one)
+bool Player::mustCoup() const {
+    return game->withRules([&](const auto& rules) { return game->mustCoup(rules, seat); });
+}
+
+// Whether the player's role may use an action under the rules of his game
+bool Player::mayUse(ActionId action) const {
+    return game->withRules([&](const auto& rules) { return rules.mayUse(role_id, action); });
+}
+
+// Throws the text of a failed result (throwing API)
+void Player::throwIfFailed(ActionResult result, ActionId action, const Player* target) const {
+    if (result != ActionResult::Ok) throw std::runtime_error(resultMessage(result, action, *this, target));
 }
 
 // Governor only method that blocks the tax action on another player
 void Player::blockTax(Player& target) {
-    if(this->role() != "Governor") throw std::runtime_error("Tax block action only permitted to Governor");
-    target.state.isTaxBlocked = true;
+    throwIfFailed(tryBlockTax(target), ActionId::BlockTax, &target);
+}
+
+ActionResult Player::tryBlockTax(Player& target) {
+    if (!mayUse(ActionId::BlockTax)) return ActionResult::WrongRole;
+    game->setFlags(target.seat, FLAG_TAX_BLOCKED);
+    return ActionResult::Ok;
 }
 
 // Spy only method that blocks the arrest action on another player
 void Player::blockArrest(Player& target) {
-    if(this->role() != "Spy") throw std::runtime_error("Arrest block action only permitted to Spy");
-    target.state.isArrestedBlocked = true;
+    throwIfFailed(tryBlockArrest(target), ActionId::BlockArrest, &target);
+}
+
+ActionResult Player::tryBlockArrest(Player& target) {
+    if (!mayUse(ActionId::BlockArrest)) return ActionResult::WrongRole;
+    game->setFlags(target.seat, FLAG_ARREST_BLOCKED);
+    return ActionResult::Ok;
 }
 
 // General only method that blocks the coup action on another player, or prevents elimination on another player
 void Player::blockCoup(Player& target) {
-    if(this->role() != "General") throw std::runtime_error("Coup block action only permitted to General");
-    target.state.onCoupTrial = false;
-
+    throwIfFailed(tryBlockCoup(target), ActionId::BlockCoup, &target);
 }
 
-// Judge only method that blocks the bribe action on another player
-void Player::blockBribe(Player& target) {
-    if(this->role() != "Judge") throw std::runtime_error("Bribe block action only permitted to Judge");
-    
-    if (game.turn() == this) {
-        // Judge is using block during their own turn: apply future bribe block
-        target.state.isBribeBlocked = true;
-    } else {
-        // Passive block via reaction: cancel bribe attempt this turn
-        target.state.bribedThisTurn = false;
-    }
-
+ActionResult Player::tryBlockCoup(Player& target) {
+    if (!mayUse(ActionId::BlockCoup)) return ActionResult::WrongRole;
+    game->clearFlags(target.seat, FLAG_COUP_TRIAL);
+    return ActionResult::Ok;
 }
 
-// Helper function to general that checks if player is on coop trial
-bool Player::onCoupTrial() const {
-    return state.onCoupTrial;
+// Baron only. Takes away 3 coins and returns 6 coins (counts as a turn)
+ActionResult Player::tryInvest() {
+    return game->withRules([&](const auto& rules) {
+        ActionResult result = checkAction(rules, ActionId::Invest); // Checks the role first
+        if (result != ActionResult::Ok) return result;
+        const int cost = rules.cost(ActionId::Invest);
+        if (coins() < cost) return ActionResult::NotEnoughCoins;
+        deductCoins(cost);
+        addCoins(rules.investReturn());
+        return ActionResult::Ok;
+    });
 }
 
-// Helper function to spy that checks if player is blocked on arrest
-bool Player::onArrestedBlocked() const {
-    return state.isArrestedBlocked; 
+// General only. Pays 5 coins to take a player off coup trial (even himself)
+ActionResult Player::tryPreventCoup(Player& target) {
+    if (!mayUse(ActionId::BlockCoup)) return ActionResult::WrongRole;
+    if (!isActive()) return ActionResult::InactivePlayer;
+    const int cost = game->withRules([](const auto& rules) { return rules.cost(ActionId::BlockCoup); });
+    if (coins() < cost) return ActionResult::NotEnoughCoins;
+    if (target.onCoupTrial() == false) return ActionResult::NotOnCoupTrial;
+
+    deductCoins(cost);
+    return tryBlockCoup(target);
 }
 
-// Helper function to governor that checks if player is blocked on tax
-bool Player::onTaxBlocked() const {
-    return state.isTaxBlocked; 
+// Judge only method that blocks the bribe action on another player
+void Player::blockBribe(Player& target) {
+    throwIfFailed(tryBlockBribe(target), ActionId::BlockBribe, &target);
 }
 
-// Helper function to judge that checks if player has taken a bribe (for 2 actions on a turn)
-bool Player::onBribe() const {
-    return state.bribedThisTurn; 
+ActionResult Player::tryBlockBribe(Player& target) {
+    if (!mayUse(ActionId::BlockBribe)) return ActionResult::WrongRole;
+    
+    if (game->table.current_turn == seat) {
+        // Judge is using block during their own turn: apply future bribe block
+        game->setFlags(target.seat, FLAG_BRIBE_BLOCKED);
+    } else if (game->table.current_turn == target.seat) {
+        // Passive block via reaction: cancel bribe attempt this turn
+        game->setBribe(false);
+    }
+    return ActionResult::Ok;
 }
 
 // Function that resets "bribedThisTurn" flag in player state - called after the player used his bribe turn
@@ -240,17 +286,14 @@ void Player::usedBribeTurn() {
     if(!onBribe())
         throw std::runtime_error(this->getName() + " Did not use bribe this turn");
     
-    state.bribedThisTurn = false;
+    game->setBribe(false);
 }
 
 
 // Resets state flags of actions that are blocking action for one turn
 void Player::resetTurnFlags() {
-    state.bribedThisTurn = false;
-    state.isSanctioned = false;
-    state.isTaxBlocked = false;
-    state.isArrestedBlocked = false;
-    state.isBribeBlocked = false;
+    if (game->table.current_turn == seat) game->setBribe(false);
+    game->clearFlags(seat, TURN_FLAGS);
 }
 
 
@@ -8,17 +8,41 @@
 #include "../Headers/General.hpp"
 #include "../Headers/PlayerFactory.hpp"
 
+#include <new>
+
 
 namespace coup {
 
+Player* createPlayerByRole(RoleId role, Game& game, const std::string& name) {
+    switch (role) {
+        case RoleId::Baron: return new Baron(game, name);
+        case RoleId::Spy: return new Spy(game, name);
+        case RoleId::Governor: return new Governor(game, name);
+        case RoleId::Merchant: return new Merchant(game, name);
+        case RoleId::Judge: return new Judge(game, name);
+        case RoleId::General: return new General(game, name);
+        default: break;
+    }
+    throw std::invalid_argument("Invalid role: " + std::string(roleName(role)));
+}
+
+Player* createPlayerByRole(RoleId role, Game& game, const std::string& name, PlayerSlot& slot) {
+    switch (role) {
+        case RoleId::Baron: return new (&slot) Baron(game, name);
+        case RoleId::Spy: return new (&slot) Spy(game, name);
+        case RoleId::Governor: return new (&slot) Governor(game, name);
+        case RoleId::Merchant: return new (&slot) Merchant(game, name);
+        case RoleId::Judge: return new (&slot) Judge(game, name);
+        case RoleId::General: return new (&slot) General(game, name);
+        default: break;
+    }
+    throw std::invalid_argument("Invalid role: " + std::string(roleName(role)));
+}
+
 Player* createPlayerByRole(const std::string& role, Game& game, const std::string& name) {
-    if (role == "Baron") return new Baron(game, name);
-    if (role == "Spy") return new Spy(game, name);
-    if (role == "Governor") return new Governor(game, name);
-    if (role == "Merchant") return new Merchant(game, name);
-    if (role == "Judge") return new Judge(game, name);
-    if (role == "General") return new General(game, name);
-    throw std::invalid_argument("Invalid role: " + role);
+    RoleId id;
+    if (!parseRole(role, id)) throw std::invalid_argument("Invalid role: " + role);
+    return createPlayerByRole(id, game, name);
 }
 
 }
@@ -0,0 +1,392 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/Replay.hpp"
+#include "../Headers/Game.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace coup {
+
+namespace {
+
+const std::uint8_t MAGIC[4] = {'C', 'P', 'R', 'P'};
+const std::uint64_t KEYFRAME = 5; // Record value that starts a keyframe (kind 5, all other fields 0)
+const std::size_t REPLAY_MAX_SEATS = 254; // Seat counts and keyframe seats are single bytes (0xFF is "no seat")
+
+// Keyframe byte of a table seat
+std::uint8_t seatByte(Seat seat) {
+    return seat == NO_SEAT ? 0xFF : static_cast<std::uint8_t>(seat);
+}
+
+// Table seat of a keyframe byte
+Seat byteSeat(std::uint8_t byte) {
+    return byte == 0xFF ? NO_SEAT : static_cast<Seat>(byte);
+}
+
+// Reads one header byte
+std::uint8_t getByte(const std::uint8_t*& p, const std::uint8_t* end) {
+    if (p == end) throw std::runtime_error("Corrupt replay: truncated header");
+    return *p++;
+}
+
+// Checks the header and returns its seat count - fills `info` if given, otherwise skips the names
+std::uint8_t parseHeader(const std::uint8_t*& p, const std::uint8_t* end, ReplayHeader* info) {
+    for (std::uint8_t expected : MAGIC) {
+        if (getByte(p, end) != expected) throw std::runtime_error("Not a replay file");
+    }
+    const std::uint8_t version = getByte(p, end);
+    if (version == 0 || version > REPLAY_VERSION) throw std::runtime_error("Unsupported replay version");
+
+    const std::uint64_t seed = getVarint(p, end);
+    std::uint64_t fingerprint = 0;
+    if (version >= 3) {
+        for (int byte = 0; byte < 8; ++byte) fingerprint |= static_cast<std::uint64_t>(getByte(p, end)) << (8 * byte);
+    }
+    const std::uint8_t seats = getByte(p, end);
+    if (seats < 2 || seats > MAX_PLAYERS) throw std::runtime_error("Corrupt replay: bad seat count");
+    for (std::uint8_t seat = 0; seat < seats; ++seat) {
+        const std::uint8_t role = getByte(p, end);
+        if (role >= ROLE_COUNT) throw std::runtime_error("Corrupt replay: bad role");
+        const std::uint64_t length = getVarint(p, end);
+        if (length > static_cast<std::uint64_t>(end - p)) throw std::runtime_error("Corrupt replay: truncated name");
+        if (info) {
+            info->roles.push_back(static_cast<RoleId>(role));
+            info->names.emplace_back(reinterpret_cast<const char*>(p), static_cast<std::size_t>(length));
+        }
+        p += length;
+    }
+    if (info) {
+        info->seed = seed;
+        info->rulesFingerprint = fingerprint;
+    }
+    return seats;
+}
+
+// Returns the first byte after a stored table
+const std::uint8_t* skipKeyframe(const std::uint8_t* p, const std::uint8_t* end, std::uint8_t seats) {
+    for (std::uint8_t seat = 0; seat < seats; ++seat) {
+        getVarint(p, end);
+        getByte(p, end);
+    }
+    if (end - p < 4) throw std::runtime_error("Corrupt replay: truncated keyframe");
+    return p + 4;
+}
+
+// Decodes the step at `p` and moves past it, skipping keyframes (false at the end of the replay)
+bool nextStep(const std::uint8_t*& p, const std::uint8_t* end, std::uint8_t seats, ReplayStep& step) {
+    std::uint64_t value;
+    do {
+        if (p == end) return false;
+        value = getVarint(p, end);
+        if (value == KEYFRAME) p = skipKeyframe(p, end, seats);
+    } while (value == KEYFRAME);
+
+    const std::uint64_t kind = value % STEP_KINDS;
+    value /= STEP_KINDS;
+    const std::uint64_t action = value % ACTION_COUNT;
+    value /= ACTION_COUNT;
+    const std::uint64_t actor = value % seats;
+    const std::uint64_t target = value / seats;
+    if (kind > static_cast<std::uint64_t>(StepKind::Pass) || target > seats) throw std::runtime_error("Corrupt replay: bad step");
+
+    step.kind = static_cast<StepKind>(kind);
+    step.action = static_cast<ActionId>(action);
+    step.actor = static_cast<Seat>(actor);
+    step.target = target == 0 ? NO_SEAT : static_cast<Seat>(target - 1);
+    return true;
+}
+
+}
+
+///////////////////////////////// Varints /////////////////////////////////
+
+// Appends a LEB128 varint
+void putVarint(std::vector<std::uint8_t>& out, std::uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Reads a LEB128 varint (throws if it runs past the end)
+std::uint64_t getVarint(const std::uint8_t*& p, const std::uint8_t* end) {
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (p == end) throw std::runtime_error("Corrupt replay: truncated varint");
+        const std::uint8_t byte = *p++;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    throw std::runtime_error("Corrupt replay: varint too long");
+}
+
+///////////////////////////////// Writer /////////////////////////////////
+
+// Writes the header of a seated table
+ReplayWriter::ReplayWriter(const Game& game, std::size_t keyframeInterval)
+    : seats(static_cast<std::uint8_t>(game.state().seat_count)), interval(keyframeInterval) {
+    if (game.state().seat_count > REPLAY_MAX_SEATS) throw std::length_error("Replays hold at most 254 seats");
+    buffer.insert(buffer.end(), MAGIC, MAGIC + sizeof(MAGIC));
+    buffer.push_back(REPLAY_VERSION);
+    putVarint(buffer, game.seed());
+    const std::uint64_t fingerprint = fingerprintRules(game.rules());
+    for (int byte = 0; byte < 8; ++byte) buffer.push_back(static_cast<std::uint8_t>(fingerprint >> (8 * byte)));
+    buffer.push_back(seats);
+    for (std::uint8_t seat = 0; seat < seats; ++seat) {
+        const Player* p = game.playerAt(seat);
+        const std::string name = p->getName();
+        buffer.push_back(static_cast<std::uint8_t>(p->roleId()));
+        putVarint(buffer, name.size());
+        buffer.insert(buffer.end(), name.begin(), name.end());
+    }
+}
+
+// Appends one step
+void ReplayWriter::record(StepKind kind, ActionId action, Seat actor, Seat target) {
+    const std::uint64_t targetField = target == NO_SEAT ? 0 : target + 1u;
+    std::uint64_t value = actor + static_cast<std::uint64_t>(seats) * targetField;
+    value = static_cast<std::uint64_t>(action) + ACTION_COUNT * value;
+    value = static_cast<std::uint64_t>(kind) + STEP_KINDS * value;
+    putVarint(buffer, value);
+    ++count;
+}
+
+// Whether a keyframe interval has passed since the last keyframe
+bool ReplayWriter::keyframeDue() const {
+    return interval != 0 && count - lastKeyframe >= interval;
+}
+
+// Appends the whole table as it is after the last step
+void ReplayWriter::keyframe(const GameState& state) {
+    putVarint(buffer, KEYFRAME);
+    for (std::uint8_t seat = 0; seat < seats; ++seat) {
+        const std::int64_t coins = state.coins[seat];
+        putVarint(buffer, static_cast<std::uint64_t>((coins << 1) ^ (coins >> 63))); // Zigzag (coins may go negative in tests)
+        buffer.push_back(state.flags[seat]);
+    }
+    buffer.push_back(seatByte(state.current_turn));
+    buffer.push_back(state.did_pay_bribe);
+    buffer.push_back(seatByte(state.last_arrested));
+    buffer.push_back(seatByte(state.last_turn));
+    lastKeyframe = count;
+}
+
+// Returns the encoded replay (header and steps)
+const std::vector<std::uint8_t>& ReplayWriter::bytes() const {
+    return buffer;
+}
+
+// Number of recorded steps
+std::size_t ReplayWriter::steps() const {
+    return count;
+}
+
+// Writes the replay to a file
+void ReplayWriter::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) throw std::runtime_error("Cannot open " + path + " for writing");
+    file.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    if (!file) throw std::runtime_error("Cannot write " + path);
+}
+
+///////////////////////////////// Reader /////////////////////////////////
+
+// Parses the header
+ReplayReader::ReplayReader(const std::uint8_t* data, std::size_t size) : last(data + size) {
+    const std::uint8_t* p = data;
+    parseHeader(p, last, &info);
+    first = cursor = p;
+}
+
+ReplayReader::ReplayReader(const std::vector<std::uint8_t>& bytes) : ReplayReader(bytes.data(), bytes.size()) {}
+
+// Returns the seed and seats of the game
+const ReplayHeader& ReplayReader::header() const {
+    return info;
+}
+
+// Decodes the next step, skipping keyframes
+bool ReplayReader::next(ReplayStep& step) {
+    if (!nextStep(cursor, last, static_cast<std::uint8_t>(info.roles.size()), step)) return false;
+    ++decoded;
+    return true;
+}
+
+// Goes back to the first step
+void ReplayReader::rewind() {
+    cursor = first;
+    decoded = 0;
+}
+
+// Number of steps decoded since the start
+std::size_t ReplayReader::position() const {
+    return decoded;
+}
+
+// Steps of the replay, decoded in place
+ReplaySteps ReplayReader::steps() const {
+    return ReplaySteps(first, last, static_cast<std::uint8_t>(info.roles.size()));
+}
+
+// Restores a stored table into a game
+void ReplayReader::loadKeyframe(Game& game, const std::uint8_t* p) const {
+    GameState state = game.state(); // Keeps the seats and roles
+    for (std::size_t seat = 0; seat < info.roles.size(); ++seat) {
+        const std::uint64_t zigzag = getVarint(p, last);
+        state.coins[seat] = static_cast<std::int16_t>(static_cast<std::int64_t>(zigzag >> 1) ^ -static_cast<std::int64_t>(zigzag & 1));
+        state.flags[seat] = getByte(p, last);
+    }
+    state.current_turn = byteSeat(p[0]);
+    state.did_pay_bribe = p[1];
+    state.last_arrested = byteSeat(p[2]);
+    state.last_turn = byteSeat(p[3]);
+    game.loadState(state);
+}
+
+// Restores the nearest keyframe at or before `step` and replays the steps after it
+std::size_t ReplayReader::seek(Game& game, std::size_t step) {
+    if (!indexed) { // One decode-only pass over the replay finds every keyframe
+        rewind();
+        for (const std::uint8_t* p = first; p != last;) {
+            if (getVarint(p, last) == KEYFRAME) {
+                keyframes.push_back(Keyframe{decoded, p});
+                p = skipKeyframe(p, last, static_cast<std::uint8_t>(info.roles.size()));
+            } else {
+                ++decoded;
+            }
+        }
+        indexed = true;
+    }
+
+    // Last keyframe with at most `step` steps before it
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), step,
+                               [](std::size_t wanted, const Keyframe& k) { return wanted < k.step; });
+    if (it == keyframes.begin()) {
+        const RuleTable& rules = game.rules(); // Outlives the game (a loaded table or a variant's)
+        game = gameFromReplay(info, &rules);
+        rewind();
+    } else {
+        --it;
+        loadKeyframe(game, it->data);
+        cursor = skipKeyframe(it->data, last, static_cast<std::uint8_t>(info.roles.size()));
+        decoded = it->step;
+    }
+
+    ReplayStep next;
+    while (decoded < step && this->next(next)) {
+        if (!applyStep(game, next)) throw std::runtime_error("Replay diverged at step " + std::to_string(decoded - 1));
+    }
+    return decoded;
+}
+
+///////////////////////////////// In-place steps /////////////////////////////////
+
+// Iterator at the first step at or after `data`
+StepIterator::StepIterator(const std::uint8_t* data, const std::uint8_t* end, std::uint8_t seats) : last(end), seats(seats) {
+    load(data);
+}
+
+// Decodes the step at or after `p` (or becomes the end iterator)
+void StepIterator::load(const std::uint8_t* p) {
+    after = p;
+    at = nextStep(after, last, seats, step) ? p : last; // `at` may point at a keyframe before the step
+}
+
+StepIterator& StepIterator::operator++() {
+    load(after);
+    return *this;
+}
+
+StepIterator StepIterator::operator++(int) {
+    StepIterator before = *this;
+    load(after);
+    return before;
+}
+
+// Range of the steps between two bytes
+ReplaySteps::ReplaySteps(const std::uint8_t* first, const std::uint8_t* last, std::uint8_t seats) : first(first), last(last), seats(seats) {}
+
+StepIterator ReplaySteps::begin() const {
+    return StepIterator(first, last, seats);
+}
+
+StepIterator ReplaySteps::end() const {
+    return StepIterator(last, last, seats);
+}
+
+// Steps of a replay, decoded in place (the header is checked but its names are not copied)
+ReplaySteps replaySteps(const std::uint8_t* data, std::size_t size) {
+    const std::uint8_t* p = data;
+    const std::uint8_t seats = parseHeader(p, data + size, nullptr);
+    return ReplaySteps(p, data + size, seats);
+}
+
+///////////////////////////////// Replayer /////////////////////////////////
+
+// Reads a replay file
+std::vector<std::uint8_t> loadReplay(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("Cannot open " + path);
+    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file) throw std::runtime_error("Cannot read " + path);
+    return bytes;
+}
+
+// Returns the table of a replay before its first step, playing by `rules` (throws if the replay used other rules)
+Game gameFromReplay(const ReplayHeader& header, const RuleTable* rules) {
+    Game game(header.seed);
+    if (rules) game.setRules(*rules);
+    if (header.rulesFingerprint != 0 && header.rulesFingerprint != fingerprintRules(game.rules())) {
+        throw std::runtime_error("Replay was recorded under other rules");
+    }
+    for (std::size_t seat = 0; seat < header.roles.size(); ++seat) {
+        game.addPlayerWithRole(header.names[seat], header.roles[seat]);
+    }
+    return game;
+}
+
+// Plays one step through the normal entry points
+bool applyStep(Game& game, const ReplayStep& step) {
+    Player* actor = game.playerAt(step.actor);
+    Player* target = step.target == NO_SEAT ? nullptr : game.playerAt(step.target);
+    switch (step.kind) {
+        case StepKind::Turn:
+            if (target) return game.handleTurnWithTarget(actor, step.action, target) == ActionResult::Ok;
+            return game.handleTurnWithNoTarget(actor, step.action) == ActionResult::Ok;
+        case StepKind::Block:
+            return target && game.handleBlockConsequences(step.action, actor, target);
+        case StepKind::MerchantPassive: { // Any role with a passive gain under the game's rules
+            const int coins = actor->coins();
+            game.handleMerchantPassive(actor);
+            return actor->coins() == coins + game.rules().passiveGain[static_cast<std::size_t>(actor->roleId())];
+        }
+        case StepKind::Eliminated:
+            game.turn(); // Eliminates the players whose coup trial came due (as the recorded call did)
+            return !actor->isActive();
+        case StepKind::Pass:
+            if (game.turn() != actor) return false;
+            game.passTurn();
+            return true;
+    }
+    return false;
+}
+
+// Plays every remaining step
+long replayGame(Game& game, ReplayReader& reader) {
+    long played = 0;
+    ReplayStep step;
+    while (reader.next(step)) {
+        if (!applyStep(game, step)) {
+            throw std::runtime_error("Replay diverged at step " + std::to_string(played));
+        }
+        ++played;
+    }
+    return played;
+}
+
+}
@@ -0,0 +1,247 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/ReplayArchive.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace coup {
+
+namespace {
+
+const std::uint8_t ARCHIVE_MAGIC[4] = {'C', 'P', 'R', 'A'};
+const std::uint8_t FOOTER_MAGIC[4] = {'C', 'P', 'R', 'E'};
+const std::size_t ARCHIVE_HEADER = sizeof(ARCHIVE_MAGIC) + 1; // Magic and version
+const std::size_t FOOTER_TAIL = 8 + sizeof(FOOTER_MAGIC); // Footer start and magic
+const std::size_t MAX_VARINT = 10; // Bytes of the longest LEB128 varint (64 bits)
+
+// Writes a LEB128 varint into a buffer of MAX_VARINT bytes and returns its length
+std::size_t encodeVarint(std::uint8_t* out, std::uint64_t value) {
+    std::size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<std::uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<std::uint8_t>(value);
+    return length;
+}
+
+// Whether the varint at `p` ends before `end` (the last game of an unfinished archive can stop inside it)
+bool varintEnds(const std::uint8_t* p, const std::uint8_t* end) {
+    while (p != end && (*p & 0x80)) ++p;
+    return p != end;
+}
+
+}
+
+///////////////////////////////// Writer /////////////////////////////////
+
+// Creates the file
+ArchiveWriter::ArchiveWriter(const std::string& path, std::size_t checkpointEvery)
+    : file(path, std::ios::binary | std::ios::trunc), interval(std::max<std::size_t>(1, checkpointEvery)) {
+    if (!file) throw std::runtime_error("Cannot open " + path + " for writing");
+    file.write(reinterpret_cast<const char*>(ARCHIVE_MAGIC), sizeof(ARCHIVE_MAGIC));
+    file.put(static_cast<char>(ARCHIVE_VERSION));
+    offset = ARCHIVE_HEADER;
+}
+
+// Writes the footer if close() was not called
+ArchiveWriter::~ArchiveWriter() {
+    try {
+        close();
+    }
+    catch (...) {
+        // The games are still readable without a footer
+    }
+}
+
+// Appends the replay of a game
+void ArchiveWriter::add(const ReplayWriter& replay) {
+    add(replay.bytes().data(), replay.bytes().size());
+}
+
+// Appends an encoded replay
+void ArchiveWriter::add(const std::uint8_t* data, std::size_t size) {
+    if (closed) throw std::logic_error("Archive is already closed");
+    if (count % interval == 0) checkpoints.push_back(offset);
+    std::uint8_t prefix[MAX_VARINT]; // Length prefix, encoded on the stack
+    const std::size_t prefixSize = encodeVarint(prefix, size);
+    file.write(reinterpret_cast<const char*>(prefix), static_cast<std::streamsize>(prefixSize));
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!file) throw std::runtime_error("Cannot write the archive");
+    offset += prefixSize + size;
+    ++count;
+}
+
+// Writes the footer and closes the file
+void ArchiveWriter::close() {
+    if (closed) return;
+    closed = true;
+    std::vector<std::uint8_t> footer;
+    putVarint(footer, count);
+    putVarint(footer, checkpoints.size());
+    for (std::uint64_t checkpoint : checkpoints) putVarint(footer, checkpoint);
+    for (int i = 0; i < 8; ++i) footer.push_back(static_cast<std::uint8_t>(offset >> (8 * i)));
+    footer.insert(footer.end(), FOOTER_MAGIC, FOOTER_MAGIC + sizeof(FOOTER_MAGIC));
+    file.write(reinterpret_cast<const char*>(footer.data()), static_cast<std::streamsize>(footer.size()));
+    file.close();
+    if (!file) throw std::runtime_error("Cannot write the archive footer");
+}
+
+// Number of games written
+std::size_t ArchiveWriter::games() const {
+    return count;
+}
+
+///////////////////////////////// Ranges /////////////////////////////////
+
+// Iterator at the game that starts at `at`
+ArchiveRange::iterator::iterator(const std::uint8_t* at, const std::uint8_t* end) : at(at), last(end) {
+    load();
+}
+
+// Reads the game at `at`
+void ArchiveRange::iterator::load() {
+    if (at == last) return;
+    const std::uint8_t* p = at;
+    const std::uint64_t size = getVarint(p, last);
+    if (size > static_cast<std::uint64_t>(last - p)) throw std::runtime_error("Corrupt archive: truncated game");
+    game = ReplayView{p, static_cast<std::size_t>(size)};
+}
+
+ArchiveRange::iterator& ArchiveRange::iterator::operator++() {
+    at = game.data + game.size;
+    load();
+    return *this;
+}
+
+ArchiveRange::iterator ArchiveRange::iterator::operator++(int) {
+    iterator before = *this;
+    ++*this;
+    return before;
+}
+
+// Games between two game boundaries
+ArchiveRange::ArchiveRange(const std::uint8_t* first, const std::uint8_t* last) : first(first), last(last) {}
+
+ArchiveRange::iterator ArchiveRange::begin() const {
+    return iterator(first, last);
+}
+
+ArchiveRange::iterator ArchiveRange::end() const {
+    return iterator(last, last);
+}
+
+// Size of the range in the file
+std::size_t ArchiveRange::bytes() const {
+    return static_cast<std::size_t>(last - first);
+}
+
+///////////////////////////////// Archive /////////////////////////////////
+
+// Maps the file and finds the checkpoints
+ReplayArchive::ReplayArchive(const std::string& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Cannot open " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(ARCHIVE_HEADER)) {
+        ::close(fd);
+        throw std::runtime_error(path + " is not a replay archive");
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) throw std::runtime_error("Cannot map " + path);
+    base = static_cast<const std::uint8_t*>(mapping);
+    ::madvise(mapping, length, MADV_SEQUENTIAL); // Scans read the archive front to back
+
+    try {
+        if (std::memcmp(base, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) != 0) throw std::runtime_error(path + " is not a replay archive");
+        if (base[sizeof(ARCHIVE_MAGIC)] == 0 || base[sizeof(ARCHIVE_MAGIC)] > ARCHIVE_VERSION) {
+            throw std::runtime_error("Unsupported archive version");
+        }
+        gamesBegin = base + ARCHIVE_HEADER;
+        gamesEnd = base + length;
+
+        const std::uint8_t* tail = base + length - FOOTER_TAIL;
+        if (length >= ARCHIVE_HEADER + FOOTER_TAIL && std::memcmp(tail + 8, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) == 0) {
+            std::uint64_t footer = 0;
+            for (int i = 0; i < 8; ++i) footer |= static_cast<std::uint64_t>(tail[i]) << (8 * i);
+            if (footer < ARCHIVE_HEADER || footer > length - FOOTER_TAIL) throw std::runtime_error("Corrupt archive: bad footer");
+            const std::uint8_t* p = base + footer;
+            count = static_cast<std::size_t>(getVarint(p, tail));
+            const std::uint64_t points = getVarint(p, tail);
+            if (points > static_cast<std::uint64_t>(tail - p)) throw std::runtime_error("Corrupt archive: bad footer");
+            checkpoints.reserve(static_cast<std::size_t>(points));
+            for (std::uint64_t i = 0; i < points; ++i) {
+                const std::uint64_t at = getVarint(p, tail);
+                if (at < ARCHIVE_HEADER || at > footer) throw std::runtime_error("Corrupt archive: bad checkpoint");
+                checkpoints.push_back(at);
+            }
+            gamesEnd = base + footer;
+        } else { // Unfinished archive - walk the game lengths once, up to the last game written in full
+            const std::uint8_t* p = gamesBegin;
+            while (p != gamesEnd) {
+                const std::uint8_t* game = p;
+                const std::uint64_t size = varintEnds(p, gamesEnd) ? getVarint(p, gamesEnd) : UINT64_MAX;
+                if (size > static_cast<std::uint64_t>(gamesEnd - p)) { // A game cut off by a crash is left out
+                    gamesEnd = game;
+                    break;
+                }
+                if (count % ARCHIVE_CHECKPOINT == 0) checkpoints.push_back(static_cast<std::uint64_t>(game - base));
+                p += size;
+                ++count;
+            }
+        }
+    }
+    catch (...) {
+        ::munmap(const_cast<std::uint8_t*>(base), length);
+        throw;
+    }
+}
+
+// Unmaps the file
+ReplayArchive::~ReplayArchive() {
+    ::munmap(const_cast<std::uint8_t*>(base), length);
+}
+
+// Number of games in the archive
+std::size_t ReplayArchive::games() const {
+    return count;
+}
+
+// Every game of the archive
+ArchiveRange ReplayArchive::all() const {
+    return ArchiveRange(gamesBegin, gamesEnd);
+}
+
+// Up to `parts` disjoint ranges of about equal size; every range starts at a checkpoint
+std::vector<ArchiveRange> ReplayArchive::partition(std::size_t parts) const {
+    std::vector<ArchiveRange> ranges;
+    if (count == 0 || parts == 0) return ranges;
+
+    const std::uint64_t begin = static_cast<std::uint64_t>(gamesBegin - base);
+    const std::uint64_t end = static_cast<std::uint64_t>(gamesEnd - base);
+    std::uint64_t from = begin;
+    for (std::size_t part = 1; part <= parts && from < end; ++part) {
+        std::uint64_t to = end;
+        if (part < parts) {
+            const std::uint64_t wanted = begin + (end - begin) * part / parts;
+            auto it = std::lower_bound(checkpoints.begin(), checkpoints.end(), wanted); // First checkpoint at or after the cut
+            to = it == checkpoints.end() ? end : *it;
+        }
+        if (to > from) {
+            ranges.emplace_back(base + from, base + to);
+            from = to;
+        }
+    }
+    return ranges;
+}
+
+}
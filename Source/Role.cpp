@@ -0,0 +1,33 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/Role.hpp"
+
+namespace coup {
+
+namespace {
+
+// Display names - indexed directly by RoleId
+const char* const ROLE_NAMES[] = {"Baron", "Spy", "Governor", "Merchant", "Judge", "General"};
+
+static_assert(sizeof(ROLE_NAMES) / sizeof(ROLE_NAMES[0]) == ROLE_COUNT, "Role names must have one entry per RoleId");
+
+}
+
+// Returns the display name of a role
+const char* roleName(RoleId role) {
+    if (role == RoleId::None) return "None";
+    return ROLE_NAMES[static_cast<std::size_t>(role)];
+}
+
+// Converts a role name into a role id (GUI / CLI boundary only)
+bool parseRole(const std::string& name, RoleId& role) {
+    for (std::size_t i = 0; i < ROLE_COUNT; ++i) {
+        if (name == ROLE_NAMES[i]) {
+            role = static_cast<RoleId>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,310 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/RuleTable.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+namespace coup {
+
+namespace {
+
+const int MAX_RULE_COINS = 1000; // Largest coin amount a rules file may set (coins are 16-bit in the game state)
+
+constexpr std::uint16_t actionBit(ActionId action) {
+    return static_cast<std::uint16_t>(1u << static_cast<unsigned>(action));
+}
+
+// The on-turn action a blocking role plays against `action` (ActionId::Count if the action has none)
+ActionId blockActionOf(ActionId action) {
+    switch (action) {
+        case ActionId::Tax: return ActionId::BlockTax;
+        case ActionId::Arrest: return ActionId::BlockArrest;
+        case ActionId::Bribe: return ActionId::BlockBribe;
+        case ActionId::Coup: return ActionId::BlockCoup;
+        default: return ActionId::Count;
+    }
+}
+
+// Lets only `role` use an action (RoleId::None lets every role use it)
+void restrictAction(RuleTable& rules, ActionId action, RoleId role) {
+    for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+        if (role == RoleId::None || static_cast<RoleId>(r) == role) rules.allowedActions[r] |= actionBit(action);
+        else rules.allowedActions[r] &= static_cast<std::uint16_t>(~actionBit(action));
+    }
+}
+
+// Writes any rules view out as a table
+template <typename R>
+RuleTable compileRules(const R& view) {
+    RuleTable rules{};
+    for (std::size_t a = 0; a < ACTION_COUNT; ++a) {
+        const ActionId action = static_cast<ActionId>(a);
+        rules.cost[a] = static_cast<std::int16_t>(view.cost(action));
+        rules.blockedBy[a] = view.blockedBy(action);
+        rules.blockCost[a] = static_cast<std::int16_t>(view.blockCost(action));
+        rules.blockPenalty[a] = static_cast<std::int16_t>(view.blockPenalty(action));
+        for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+            if (view.mayUse(static_cast<RoleId>(r), action)) rules.allowedActions[r] |= actionBit(action);
+        }
+    }
+    rules.gatherGain = static_cast<std::int16_t>(view.gatherGain());
+    rules.investReturn = static_cast<std::int16_t>(view.investReturn());
+    rules.forcedCoupCoins = static_cast<std::int16_t>(view.forcedCoupCoins());
+    for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+        const RoleId role = static_cast<RoleId>(r);
+        rules.taxGain[r] = static_cast<std::int16_t>(view.taxGain(role));
+        rules.arrestLoss[r] = static_cast<std::int16_t>(view.arrestLoss(role));
+        rules.arrestGain[r] = static_cast<std::int16_t>(view.arrestGain(role));
+        rules.arrestRefund[r] = static_cast<std::int16_t>(view.arrestRefund(role));
+        rules.sanctionSurcharge[r] = static_cast<std::int16_t>(view.sanctionSurcharge(role));
+        rules.sanctionRefund[r] = static_cast<std::int16_t>(view.sanctionRefund(role));
+        rules.passiveThreshold[r] = static_cast<std::int16_t>(view.passiveThreshold(role));
+        rules.passiveGain[r] = static_cast<std::int16_t>(view.passiveGain(role));
+    }
+    return rules;
+}
+
+// Settings that take one amount per action, and the array they fill
+struct ActionSetting {
+    const char* name;
+    std::int16_t (RuleTable::*values)[ACTION_COUNT];
+};
+
+// Settings that take one amount per role (or `all`), and the array they fill
+struct RoleSetting {
+    const char* name;
+    std::int16_t (RuleTable::*values)[ROLE_COUNT];
+};
+
+const ActionSetting ACTION_SETTINGS[] = {
+    {"cost", &RuleTable::cost},
+    {"block_cost", &RuleTable::blockCost},
+    {"block_penalty", &RuleTable::blockPenalty},
+};
+
+const RoleSetting ROLE_SETTINGS[] = {
+    {"tax", &RuleTable::taxGain},
+    {"arrest_loss", &RuleTable::arrestLoss},
+    {"arrest_gain", &RuleTable::arrestGain},
+    {"arrest_refund", &RuleTable::arrestRefund},
+    {"sanction_surcharge", &RuleTable::sanctionSurcharge},
+    {"sanction_refund", &RuleTable::sanctionRefund},
+    {"passive_threshold", &RuleTable::passiveThreshold},
+    {"passive_gain", &RuleTable::passiveGain},
+};
+
+}
+
+// The only role allowed to use the action (RoleId::None if more)
+RoleId RuleTable::requiredRole(ActionId action) const noexcept {
+    RoleId only = RoleId::None;
+    for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+        if (!mayUse(static_cast<RoleId>(r), action)) continue;
+        if (only != RoleId::None) return RoleId::None;
+        only = static_cast<RoleId>(r);
+    }
+    return only;
+}
+
+// Hash of every setting (FNV-1a over the values, so padding never counts) - replays store it to refuse other rules
+std::uint64_t fingerprintRules(const RuleTable& rules) {
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&](long value) {
+        for (int byte = 0; byte < 2; ++byte) {
+            hash ^= static_cast<std::uint8_t>(value >> (8 * byte));
+            hash *= 1099511628211ull;
+        }
+    };
+    for (std::size_t a = 0; a < ACTION_COUNT; ++a) {
+        mix(rules.cost[a]);
+        mix(static_cast<long>(rules.blockedBy[a]));
+        mix(rules.blockCost[a]);
+        mix(rules.blockPenalty[a]);
+    }
+    for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+        mix(rules.allowedActions[r]);
+        mix(rules.taxGain[r]);
+        mix(rules.arrestLoss[r]);
+        mix(rules.arrestGain[r]);
+        mix(rules.arrestRefund[r]);
+        mix(rules.sanctionSurcharge[r]);
+        mix(rules.sanctionRefund[r]);
+        mix(rules.passiveThreshold[r]);
+        mix(rules.passiveGain[r]);
+    }
+    mix(rules.gatherGain);
+    mix(rules.investReturn);
+    mix(rules.forcedCoupCoins);
+    return hash == 0 ? 1 : hash; // 0 stands for "no fingerprint" in old replays
+}
+
+bool RuleTable::operator==(const RuleTable& other) const noexcept {
+    return std::equal(cost, cost + ACTION_COUNT, other.cost)
+        && std::equal(blockedBy, blockedBy + ACTION_COUNT, other.blockedBy)
+        && std::equal(blockCost, blockCost + ACTION_COUNT, other.blockCost)
+        && std::equal(blockPenalty, blockPenalty + ACTION_COUNT, other.blockPenalty)
+        && std::equal(allowedActions, allowedActions + ROLE_COUNT, other.allowedActions)
+        && gatherGain == other.gatherGain && investReturn == other.investReturn && forcedCoupCoins == other.forcedCoupCoins
+        && std::equal(taxGain, taxGain + ROLE_COUNT, other.taxGain)
+        && std::equal(arrestLoss, arrestLoss + ROLE_COUNT, other.arrestLoss)
+        && std::equal(arrestGain, arrestGain + ROLE_COUNT, other.arrestGain)
+        && std::equal(arrestRefund, arrestRefund + ROLE_COUNT, other.arrestRefund)
+        && std::equal(sanctionSurcharge, sanctionSurcharge + ROLE_COUNT, other.sanctionSurcharge)
+        && std::equal(sanctionRefund, sanctionRefund + ROLE_COUNT, other.sanctionRefund)
+        && std::equal(passiveThreshold, passiveThreshold + ROLE_COUNT, other.passiveThreshold)
+        && std::equal(passiveGain, passiveGain + ROLE_COUNT, other.passiveGain);
+}
+
+// Every compile-time variant written out as a table (built once, on first use)
+template <std::size_t... I>
+const RuleTable* variantTables(std::index_sequence<I...>) {
+    static const RuleTable tables[] = {compileRules(PolicyRules<std::tuple_element_t<I, RuleVariants>>())...};
+    return tables;
+}
+
+// A compile-time variant as a table
+const RuleTable& variantRules(std::size_t variant) {
+    return variantTables(std::make_index_sequence<RULE_VARIANT_COUNT>())[variant];
+}
+
+// Variant whose table `rules` is (RULE_VARIANT_COUNT for any other table - a rules file)
+std::size_t variantOf(const RuleTable& rules) {
+    for (std::size_t v = 0; v < RULE_VARIANT_COUNT; ++v) {
+        if (&rules == &variantRules(v)) return v;
+    }
+    return RULE_VARIANT_COUNT;
+}
+
+// NAME of a variant
+const char* ruleVariantName(std::size_t variant) {
+    return withRuleVariant(variant, [](auto view) { return decltype(view)::NAME; });
+}
+
+// Finds a variant by its NAME (false if none)
+bool parseRuleVariant(const std::string& name, std::size_t& variant) {
+    for (std::size_t v = 0; v < RULE_VARIANT_COUNT; ++v) {
+        if (name != ruleVariantName(v)) continue;
+        variant = v;
+        return true;
+    }
+    return false;
+}
+
+// The built-in Rules policy as a table (what a rules file starts from)
+const RuleTable& defaultRules() {
+    return variantRules(0);
+}
+
+// Compiles a rules file on top of the default rules. Every line is `setting [action | role | all] value`, # starts a comment
+// (a file that makes the forced coup unplayable - below the Coup's cost, or a Coup some roles can't use - is refused):
+//   cost Coup 7            block Bribe Judge       block_cost Coup 5       block_penalty Coup 7    role Invest Baron
+//   gather 1               invest_return 6         forced_coup 10          tax all 2               tax Governor 3
+//   arrest_loss Merchant 2 arrest_gain Merchant 0  arrest_refund General 1 sanction_surcharge Judge 1
+//   sanction_refund Baron 1                        passive_threshold Merchant 3                    passive_gain Merchant 1
+RuleTable parseRules(std::istream& in, const std::string& source) {
+    RuleTable rules = defaultRules();
+    std::string line;
+    for (int number = 1; std::getline(in, line); ++number) {
+        const std::string where = source + ":" + std::to_string(number) + ": ";
+        std::istringstream words(line.substr(0, line.find('#')));
+        std::string setting, name, value, extra;
+        if (!(words >> setting)) continue; // Blank or comment line
+        words >> name >> value >> extra;
+        if (!extra.empty()) throw std::invalid_argument(where + "too many values");
+
+        // Settings with a single value shift the name into the value
+        const bool scalar = setting == "gather" || setting == "invest_return" || setting == "forced_coup";
+        if (scalar) {
+            if (!value.empty()) throw std::invalid_argument(where + "too many values");
+            value = name;
+        }
+        if (value.empty()) throw std::invalid_argument(where + "missing value");
+
+        auto parseAmount = [&](const std::string& text) {
+            std::size_t used = 0;
+            int amount = -1;
+            try {
+                amount = std::stoi(text, &used);
+            }
+            catch (const std::exception&) {
+                used = 0;
+            }
+            if (used != text.size() || amount < 0 || amount > MAX_RULE_COINS) {
+                throw std::invalid_argument(where + "'" + text + "' is not a coin amount (0-" + std::to_string(MAX_RULE_COINS) + ")");
+            }
+            return static_cast<std::int16_t>(amount);
+        };
+        auto parseActionName = [&](const std::string& text) {
+            ActionId action;
+            if (!parseAction(text, action)) throw std::invalid_argument(where + "unknown action '" + text + "'");
+            return action;
+        };
+        auto parseRoleName = [&](const std::string& text, bool allowNone) {
+            RoleId role;
+            if (allowNone && text == "None") return RoleId::None;
+            if (!parseRole(text, role)) throw std::invalid_argument(where + "unknown role '" + text + "'");
+            return role;
+        };
+
+        if (setting == "gather") rules.gatherGain = parseAmount(value);
+        else if (setting == "invest_return") rules.investReturn = parseAmount(value);
+        else if (setting == "forced_coup") {
+            rules.forcedCoupCoins = parseAmount(value);
+            if (rules.forcedCoupCoins == 0) throw std::invalid_argument(where + "forced_coup must be at least 1");
+        }
+        else if (setting == "role") restrictAction(rules, parseActionName(name), parseRoleName(value, true));
+        else if (setting == "block") {
+            // The blocking role also gets the on-turn block action (BlockTax for Tax, ...) - None: nobody blocks
+            const ActionId action = parseActionName(name);
+            const RoleId role = parseRoleName(value, true);
+            const ActionId block = blockActionOf(action);
+            if (block == ActionId::Count) throw std::invalid_argument(where + "'" + name + "' can't be blocked");
+            rules.blockedBy[static_cast<std::size_t>(action)] = role;
+            if (role != RoleId::None) restrictAction(rules, block, role);
+            else for (std::uint16_t& allowed : rules.allowedActions) allowed &= static_cast<std::uint16_t>(~actionBit(block));
+        }
+        else {
+            bool known = false;
+            for (const ActionSetting& s : ACTION_SETTINGS) {
+                if (setting != s.name) continue;
+                (rules.*s.values)[static_cast<std::size_t>(parseActionName(name))] = parseAmount(value);
+                known = true;
+            }
+            for (const RoleSetting& s : ROLE_SETTINGS) {
+                if (setting != s.name) continue;
+                const std::int16_t amount = parseAmount(value);
+                if (name == "all") std::fill(std::begin(rules.*s.values), std::end(rules.*s.values), amount);
+                else (rules.*s.values)[static_cast<std::size_t>(parseRoleName(name, false))] = amount;
+                known = true;
+            }
+            if (!known) throw std::invalid_argument(where + "unknown setting '" + setting + "'");
+        }
+    }
+
+    // A forced coup must be playable by everyone who reaches it, or that player would have no move at all
+    const std::size_t coup = static_cast<std::size_t>(ActionId::Coup);
+    if (rules.forcedCoupCoins < rules.cost[coup]) {
+        throw std::invalid_argument(source + ": forced_coup " + std::to_string(rules.forcedCoupCoins) +
+                                    " is below the cost of a Coup (" + std::to_string(rules.cost[coup]) + ")");
+    }
+    for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+        if (!rules.mayUse(static_cast<RoleId>(r), ActionId::Coup)) {
+            throw std::invalid_argument(source + ": every role must be able to Coup (a forced coup is their only move)");
+        }
+    }
+    return rules;
+}
+
+// Same as parseRules on a file (throws std::runtime_error if it can't be read)
+RuleTable loadRules(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot open " + path);
+    return parseRules(file, path);
+}
+
+}
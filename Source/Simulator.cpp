@@ -0,0 +1,133 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/Simulator.hpp"
+#include "../Headers/Game.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace coup {
+
+namespace {
+
+// Names of the simulated seats - P1, P2, ... (built once, copied into every game)
+const std::vector<std::string>& seatNames() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> all;
+        for (std::size_t seat = 0; seat < MAX_PLAYERS; ++seat) all.push_back("P" + std::to_string(seat + 1));
+        return all;
+    }();
+    return names;
+}
+
+// Per-thread results, padded to a cache line so workers never share one
+struct alignas(64) WorkerResult {
+    SimResult result;
+};
+
+// Plays one game with random legal moves and adds it to the results (depends only on its seed)
+void playGame(const SimConfig& config, std::uint64_t seed, SimResult& out) {
+    Game game(seed); // Roles and moves all come from the game's own generator
+    if (config.rules) game.setRules(*config.rules);
+    const std::vector<std::string>& names = seatNames();
+    for (int seat = 0; seat < config.players; ++seat) {
+        if (config.roles.empty()) game.addPlayerWithRandomRole(names[seat]);
+        else game.addPlayerWithRole(names[seat], config.roles[seat]);
+        out.seatsByRole[static_cast<std::size_t>(game.playerAt(seat)->roleId())]++;
+    }
+
+    long turns = 0;
+    Player* winner = nullptr;
+    while (turns < config.maxTurns) {
+        Player* current = game.turn();
+        if ((winner = game.winner()) != nullptr) break;
+        if (!current->onBribe()) game.handleMerchantPassive(current); // Start of a new turn
+
+        const Move move = game.randomLegalAction(current, game.random());
+        if (move.action == ActionId::Count) {
+            out.passes++;
+            game.passTurn();
+        } else {
+            if (move.target == NO_SEAT) {
+                game.handleTurnWithNoTarget(current, move.action);
+            } else {
+                game.handleTurnWithTarget(current, move.action, game.playerAt(move.target));
+            }
+            out.actionCounts[static_cast<std::size_t>(move.action)]++;
+        }
+        ++turns;
+    }
+    if (!winner) winner = game.winner();
+
+    out.games++;
+    if (!winner) {
+        out.unfinished++;
+        return;
+    }
+    out.totalTurns += turns;
+    out.shortestGame = out.shortestGame == 0 ? turns : std::min(out.shortestGame, turns);
+    out.longestGame = std::max(out.longestGame, turns);
+    out.winsByRole[static_cast<std::size_t>(winner->roleId())]++;
+    out.winsBySeat[winner->seatIndex()]++;
+}
+
+}
+
+// Adds the counts of another batch
+void SimResult::merge(const SimResult& other) {
+    games += other.games;
+    unfinished += other.unfinished;
+    totalTurns += other.totalTurns;
+    if (other.shortestGame != 0) shortestGame = shortestGame == 0 ? other.shortestGame : std::min(shortestGame, other.shortestGame);
+    longestGame = std::max(longestGame, other.longestGame);
+    passes += other.passes;
+    for (std::size_t i = 0; i < ROLE_COUNT; ++i) {
+        winsByRole[i] += other.winsByRole[i];
+        seatsByRole[i] += other.seatsByRole[i];
+    }
+    for (std::size_t i = 0; i < MAX_PLAYERS; ++i) winsBySeat[i] += other.winsBySeat[i];
+    for (std::size_t i = 0; i < ACTION_COUNT; ++i) actionCounts[i] += other.actionCounts[i];
+}
+
+// Simulation speed
+double SimResult::gamesPerSecond() const {
+    return seconds > 0 ? games / seconds : 0;
+}
+
+// Plays config.games random-move games across the worker threads.
+// Game i always uses the seed Rng::streamSeed(config.seed, i), and every count is a sum, so the merged
+// result is the same for any number of threads.
+SimResult runSimulation(const SimConfig& config) {
+    if (config.players < 2 || config.players > static_cast<int>(MAX_PLAYERS)) {
+        throw std::invalid_argument("A simulated game needs 2-" + std::to_string(MAX_PLAYERS) + " players");
+    }
+    if (!config.roles.empty() && config.roles.size() != static_cast<std::size_t>(config.players)) {
+        throw std::invalid_argument("Give one role per seat (or none for random roles)");
+    }
+
+    unsigned threads = config.threads != 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<long>(threads, std::max(1L, config.games)));
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<WorkerResult> workers(threads);
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&config, &workers, t, threads]() {
+            for (long game = t; game < config.games; game += threads) {
+                playGame(config, Rng::streamSeed(config.seed, game), workers[t].result);
+            }
+        });
+    }
+    for (std::thread& worker : pool) worker.join();
+
+    SimResult total;
+    for (const WorkerResult& worker : workers) total.merge(worker.result);
+    total.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total;
+}
+
+}
@@ -0,0 +1,94 @@
+// davidkitinberg@gmail.com
+
+#include "../Headers/UndoJournal.hpp"
+#include "../Headers/Zobrist.hpp"
+
+namespace coup {
+
+// Opens a scope - the outermost scope marks where the entry starts
+UndoJournal::Scope::Scope(UndoJournal& journal) : journal(journal) {
+    if (journal.depth++ == 0) {
+        journal.scope_start = static_cast<std::uint32_t>(journal.records.size());
+    }
+}
+
+// Closes a scope - the outermost scope turns its changes (if any) into one entry
+UndoJournal::Scope::~Scope() {
+    if (--journal.depth == 0 && journal.records.size() > journal.scope_start) {
+        journal.entries.push_back(journal.scope_start);
+    }
+}
+
+// Starts / stops recording (the journal is cleared)
+void UndoJournal::setEnabled(bool on) {
+    enabled = on;
+    clear();
+}
+
+// Returns whether changes are recorded
+bool UndoJournal::isEnabled() const {
+    return enabled;
+}
+
+// Drops every entry (the buffers keep their capacity)
+void UndoJournal::clear() {
+    records.clear();
+    entries.clear();
+    scope_start = 0;
+}
+
+// Records a change (its own entry when no scope is open)
+void UndoJournal::record(UndoRecord::Kind kind, Seat seat, int value) {
+    if (!enabled) return;
+    if (depth == 0) {
+        entries.push_back(static_cast<std::uint32_t>(records.size()));
+    }
+    records.push_back(UndoRecord{kind, seat, static_cast<std::int16_t>(value)});
+}
+
+// Number of entries that can be undone
+std::size_t UndoJournal::size() const {
+    return entries.size();
+}
+
+// Reverts the newest entry on the state, newest change first (false if there is none)
+bool UndoJournal::undo(GameState& state) {
+    if (entries.empty() || depth != 0) return false;
+
+    std::uint32_t start = entries.back();
+    for (std::size_t i = records.size(); i-- > start; ) {
+        const UndoRecord& r = records[i];
+        switch (r.kind) {
+            case UndoRecord::Coins: {
+                std::int16_t coins = static_cast<std::int16_t>(state.coins[r.seat] - r.value);
+                state.hash ^= zobrist::coins(r.seat, state.coins[r.seat]) ^ zobrist::coins(r.seat, coins);
+                state.coins[r.seat] = coins;
+                break;
+            }
+            case UndoRecord::Flags:
+                state.hash ^= zobrist::flags(r.seat, static_cast<std::uint8_t>(r.value));
+                state.flags[r.seat] ^= static_cast<std::uint8_t>(r.value);
+                if (r.value & FLAG_ACTIVE) toggleSeat(state.active_seats, r.seat);
+                if (r.value & FLAG_COUP_TRIAL) toggleSeat(state.trial_seats, r.seat);
+                break;
+            case UndoRecord::Turn:
+                state.hash ^= zobrist::turn(state.current_turn) ^ zobrist::turn(static_cast<Seat>(r.value));
+                state.current_turn = static_cast<Seat>(r.value);
+                break;
+            case UndoRecord::Bribe:
+                state.hash ^= zobrist::bribe(state.did_pay_bribe) ^ zobrist::bribe(static_cast<std::uint8_t>(r.value));
+                state.did_pay_bribe = static_cast<std::uint8_t>(r.value);
+                break;
+            case UndoRecord::LastArrested:
+                state.hash ^= zobrist::arrested(state.last_arrested) ^ zobrist::arrested(static_cast<Seat>(r.value));
+                state.last_arrested = static_cast<Seat>(r.value);
+                break;
+            case UndoRecord::LastTurn: state.last_turn = static_cast<Seat>(r.value); break;
+        }
+    }
+    records.resize(start);
+    entries.pop_back();
+    return true;
+}
+
+}
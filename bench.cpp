@@ -0,0 +1,802 @@
+// davidkitinberg@gmail.com
+
+#include "Headers/Game.hpp"
+#include "Headers/PlayerFactory.hpp"
+#include "Headers/MctsBot.hpp"
+#include "Headers/ReplayArchive.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace coup;
+
+// Sink that keeps the compiler from optimizing the measured work away
+static volatile long benchSink = 0;
+
+// Number of heap allocations made by the process, and their bytes (counted by the operator new below).
+// Relaxed atomics - the archive scan and the simulator allocate from several threads at once.
+static std::atomic<std::size_t> allocationCount{0};
+static std::atomic<std::size_t> allocatedBytes{0};
+
+// Every operator stays out of line: inlined into a caller, GCC would see malloc / free meet operator new / delete
+// and warn (-Wmismatched-new-delete), although the pair below is consistent
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size)) return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// Runs `body` for `iterations` rounds and prints the average number of heap allocations of one round
+template <typename Body>
+double countAllocations(const char* label, long iterations, Body&& body) {
+    std::size_t before = allocationCount;
+    for (long i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    double perOp = static_cast<double>(allocationCount - before) / iterations;
+    std::cout << "  " << label << ": " << perOp << " allocations/op\n";
+    return perOp;
+}
+
+// Runs `body` for `iterations` rounds and prints the average time of one round
+template <typename Body>
+double measure(const char* label, long iterations, Body&& body) {
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < iterations; ++i) {
+        body(i);
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+    std::cout << "  " << label << ": " << ns << " ns/op\n";
+    return ns;
+}
+
+// Adds the six standard roles to a game (same table as the unit tests)
+static void setUpTable(Game& game) {
+    game.addPlayerWithRole("Dexter", "Spy");
+    game.addPlayerWithRole("Debra", "Governor");
+    game.addPlayerWithRole("Angel", "General");
+    game.addPlayerWithRole("Joey", "Baron");
+    game.addPlayerWithRole("James", "Merchant");
+    game.addPlayerWithRole("Arthur", "Judge");
+}
+
+/////////////////////////////// Action dispatch ///////////////////////////////
+
+// The string if/else chain Game used before the action table (kept only as a baseline)
+static int legacyDispatch(const std::string& action) {
+    if (action == "Arrest") return 0;
+    else if (action == "Sanction") return 1;
+    else if (action == "Coup") return 2;
+    else if (action == "BlockTax") return 3;
+    else if (action == "BlockCoup") return 4;
+    else if (action == "BlockBribe") return 5;
+    else if (action == "BlockArrest") return 6;
+    else if (action == "Tax") return 7;
+    else if (action == "Bribe") return 8;
+    else if (action == "Gather") return 9;
+    else if (action == "Invest") return 10;
+    return -1;
+}
+
+static void benchActionDispatch() {
+    std::cout << "\n=========== Action dispatch ===========\n";
+    const long iterations = 20000000;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < ACTION_COUNT; ++i) names.push_back(actionName(static_cast<ActionId>(i)));
+
+    double legacy = measure("string if/else chain", iterations, [&](long i) {
+        benchSink = benchSink + legacyDispatch(names[i % ACTION_COUNT]);
+    });
+    double table = measure("ActionId table lookup", iterations, [&](long i) {
+        const ActionDescriptor& desc = describe(static_cast<ActionId>(i % ACTION_COUNT));
+        benchSink = benchSink + desc.needsTarget + desc.endsTurn;
+    });
+    std::cout << "  speedup: " << legacy / table << "x\n";
+
+    // Full turns through both entry points (gather, with coins kept below the forced coup limit)
+    const long turns = 2000000;
+    std::vector<std::string> log;
+    Game byName;
+    setUpTable(byName);
+    double nameTurn = measure("turn via action name", turns, [&](long) {
+        Player* p = byName.turn();
+        byName.handleTurnWithNoTarget(p, "Gather", log);
+        if (p->coins() >= 9) p->deductCoins(9);
+        log.clear();
+    });
+    Game byId;
+    setUpTable(byId);
+    double idTurn = measure("turn via ActionId", turns, [&](long) {
+        Player* p = byId.turn();
+        byId.handleTurnWithNoTarget(p, ActionId::Gather, log);
+        if (p->coins() >= 9) p->deductCoins(9);
+        log.clear();
+    });
+    std::cout << "  speedup: " << nameTurn / idTurn << "x\n";
+}
+
+/////////////////////////////// Role checks ///////////////////////////////
+
+static void benchRoleChecks() {
+    std::cout << "\n=========== Role checks ===========\n";
+    const long iterations = 20000000;
+
+    Game game;
+    setUpTable(game);
+    std::vector<Player*> players = game.getPlayers();
+
+    // A single rule check (the Merchant test done by arrest and the Merchant passive)
+    measure("role() name compare", iterations, [&](long i) {
+        benchSink = benchSink + (players[i % players.size()]->role() == "Merchant");
+    });
+    measure("roleId() compare", iterations, [&](long i) {
+        benchSink = benchSink + (players[i % players.size()]->roleId() == RoleId::Merchant);
+    });
+    countAllocations("role() name compare", 1000, [&](long i) {
+        benchSink = benchSink + (players[i % players.size()]->role() == "Merchant");
+    });
+    countAllocations("roleId() compare", 1000, [&](long i) {
+        benchSink = benchSink + (players[i % players.size()]->roleId() == RoleId::Merchant);
+    });
+
+    // Whole turns that go through the role checks (arrest of the next seat + Merchant passive)
+    std::vector<std::string> log;
+    log.reserve(16);
+    countAllocations("arrest turn", 100000, [&](long i) {
+        Player* p = game.turn(); // Nobody gets eliminated, so seat i % 6 plays turn i
+        Player* target = players[(i + 1) % players.size()];
+        target->addCoins(2);
+        game.handleTurnWithTarget(p, ActionId::Arrest, target, log);
+        game.handleMerchantPassive(game.turn(), log);
+        if (p->coins() >= 9) p->deductCoins(9);
+        log.clear();
+    });
+}
+
+/////////////////////////////// Game cloning ///////////////////////////////
+
+static void benchClone() {
+    std::cout << "\n=========== Game cloning ===========\n";
+    const long iterations = 1000000;
+
+    Game game;
+    setUpTable(game);
+
+    double cloneNs = measure("Game::clone()", iterations, [&](long) {
+        Game fork = game.clone();
+        benchSink = benchSink + fork.state().seat_count;
+    });
+    std::cout << "  clones per second: " << 1e9 / cloneNs << "\n";
+    countAllocations("Game::clone()", 1000, [&](long) {
+        Game fork = game.clone();
+        benchSink = benchSink + fork.state().seat_count;
+    });
+
+    double copyNs = measure("GameState copy", iterations * 20, [&](long) {
+        GameState copy = game.state();
+        benchSink = benchSink + copy.seat_count;
+    });
+    std::cout << "  state copies per second: " << 1e9 / copyNs << "\n";
+
+    measure("Game move there and back", iterations, [&](long) {
+        Game moved(std::move(game));
+        game = std::move(moved);
+    });
+
+    // A simulated game: seat six players, play nothing, tear down
+    auto setUp = [&](long) {
+        Game fresh;
+        setUpTable(fresh);
+        benchSink = benchSink + fresh.state().seat_count;
+    };
+    measure("set up and destroy a six-player game", iterations, setUp);
+    countAllocations("set up and destroy a six-player game", 1000, setUp);
+}
+
+/////////////////////////////// Role specials ///////////////////////////////
+
+static void benchRoleSpecials() {
+    std::cout << "\n=========== Role specials ===========\n";
+    const long iterations = 20000000;
+
+    // One table per role, with that role on the move
+    auto tableOf = [](RoleId role) {
+        Game game;
+        game.addPlayerWithRole("First", role);
+        game.addPlayerWithRole("Second", RoleId::Spy);
+        game.playerAt(0)->addCoins(3);
+        return game;
+    };
+    Game baronTable = tableOf(RoleId::Baron);
+    Game governorTable = tableOf(RoleId::Governor);
+    Game spyTable = tableOf(RoleId::Spy);
+    Player* baron = baronTable.playerAt(0);
+    Player* governor = governorTable.playerAt(0);
+    Player* spy = spyTable.playerAt(0);
+
+    // Action handlers called straight from the action table (coins are put back after each call)
+    const ActionHandler invest = describe(ActionId::Invest).handler;
+    const ActionHandler tax = describe(ActionId::Tax).handler;
+    measure("Invest handler (Baron)", iterations, [&](long) {
+        benchSink = benchSink + static_cast<int>(invest(baronTable, *baron, nullptr));
+        baron->deductCoins(3);
+    });
+    measure("Invest handler (not a Baron)", iterations, [&](long) {
+        benchSink = benchSink + static_cast<int>(invest(spyTable, *spy, nullptr));
+    });
+    measure("Tax handler (Governor)", iterations, [&](long) {
+        benchSink = benchSink + static_cast<int>(tax(governorTable, *governor, nullptr));
+        governor->deductCoins(3);
+    });
+    measure("Tax handler (other role)", iterations, [&](long) {
+        benchSink = benchSink + static_cast<int>(tax(spyTable, *spy, nullptr));
+        spy->deductCoins(2);
+    });
+
+    // The role test on its own: RTTI against the role tag
+    std::vector<Player*> players = {baron, governor, spy};
+    measure("dynamic_cast<Baron*>", iterations, [&](long i) {
+        benchSink = benchSink + (dynamic_cast<Baron*>(players[i % 3]) != nullptr);
+    });
+    measure("roleId() == RoleId::Baron", iterations, [&](long i) {
+        benchSink = benchSink + (players[i % 3]->roleId() == RoleId::Baron);
+    });
+}
+
+/////////////////////////////// Legal moves ///////////////////////////////
+
+static void benchLegalMoves() {
+    std::cout << "\n=========== Legal moves ===========\n";
+    const long iterations = 5000000;
+
+    Game game;
+    setUpTable(game);
+    for (Player* p : game.getPlayers()) p->addCoins(7);
+    Player* current = game.turn();
+
+    measure("Game::legalActions()", iterations, [&](long) {
+        MoveList moves = game.legalActions(current);
+        benchSink = benchSink + moves.size();
+    });
+    countAllocations("Game::legalActions()", 1000, [&](long) {
+        MoveList moves = game.legalActions(current);
+        benchSink = benchSink + moves.size();
+    });
+
+    // The old way: try a move on a copy of the table and see if it fails
+    std::vector<std::string> log;
+    log.reserve(16);
+    measure("probe an illegal move on a clone (throws)", 200000, [&](long) {
+        Game probe = game.clone();
+        probe.handleTurnWithTarget(probe.turn(), ActionId::Arrest, probe.playerAt(0), log);
+        benchSink = benchSink + log.size();
+        log.clear();
+    });
+}
+
+/////////////////////////////// Illegal moves ///////////////////////////////
+
+static void benchIllegalMoves() {
+    std::cout << "\n=========== Illegal moves ===========\n";
+    const long iterations = 1000000;
+
+    Game game;
+    setUpTable(game);
+    Player* current = game.turn();
+    Player* target = game.getPlayers()[1]; // Has no coins, so the arrest is refused
+
+    double thrown = measure("arrest() throws", iterations, [&](long) {
+        try {
+            current->arrest(*target);
+        }
+        catch (const std::exception& e) {
+            benchSink = benchSink + e.what()[0];
+        }
+    });
+    double returned = measure("tryArrest() returns a code", iterations, [&](long) {
+        benchSink = benchSink + static_cast<int>(current->tryArrest(*target));
+    });
+    std::cout << "  speedup: " << thrown / returned << "x\n";
+    countAllocations("arrest() throws", 1000, [&](long) {
+        try {
+            current->arrest(*target);
+        }
+        catch (const std::exception& e) {
+            benchSink = benchSink + e.what()[0];
+        }
+    });
+    countAllocations("tryArrest() returns a code", 1000, [&](long) {
+        benchSink = benchSink + static_cast<int>(current->tryArrest(*target));
+    });
+}
+
+/////////////////////////////// State hashing ///////////////////////////////
+
+static void benchHashing() {
+    std::cout << "\n=========== State hashing ===========\n";
+    const long iterations = 5000000;
+
+    Game game;
+    setUpTable(game);
+    for (Player* p : game.getPlayers()) p->addCoins(3);
+
+    measure("incremental Game::hash()", iterations, [&](long) {
+        benchSink = benchSink + static_cast<long>(game.hash());
+    });
+    measure("full zobrist::compute()", iterations, [&](long) {
+        benchSink = benchSink + static_cast<long>(zobrist::compute(game.state()));
+    });
+
+    // Cost of keeping the hash up to date on a coin change
+    Player* p = game.getPlayers()[0];
+    measure("addCoins() with hash update", iterations, [&](long i) {
+        p->addCoins(i & 1 ? -1 : 1);
+    });
+}
+
+/////////////////////////////// Random generators ///////////////////////////////
+
+static void benchRandom() {
+    std::cout << "\n=========== Random generators ===========\n";
+    const long iterations = 50000000;
+
+    std::mt19937 mt(1);
+    std::uniform_int_distribution<> dis(0, 23);
+    Rng rng(1);
+    std::cout << "  state size: mt19937 " << sizeof(mt) << " bytes, Rng " << sizeof(rng) << " bytes\n";
+    double mtNs = measure("mt19937 + uniform_int_distribution", iterations, [&](long) {
+        benchSink = benchSink + dis(mt);
+    });
+    double rngNs = measure("Rng::below()", iterations, [&](long) {
+        benchSink = benchSink + rng.below(24);
+    });
+    std::cout << "  speedup: " << mtNs / rngNs << "x\n";
+}
+
+/////////////////////////////// MCTS bot ///////////////////////////////
+
+static void benchMcts() {
+    std::cout << "\n=========== MCTS bot ===========\n";
+
+    Game game;
+    setUpTable(game);
+    for (Player* p : game.getPlayers()) p->addCoins(3);
+
+    // Engine speed as seen by the bot - track this number over time
+    for (bool heuristic : {false, true}) {
+        MctsConfig config;
+        config.iterations = 20000;
+        config.heuristicRollouts = heuristic;
+        MctsBot bot(config);
+        bot.chooseMove(game);
+        std::cout << "  " << (heuristic ? "heuristic" : "random") << " rollouts: " << bot.lastStats().playoutsPerSecond()
+                  << " playouts/s (" << bot.lastStats().playouts << " in " << bot.lastStats().milliseconds << " ms)\n";
+    }
+}
+
+/////////////////////////////// Event stream ///////////////////////////////
+
+static void benchEvents() {
+    std::cout << "\n=========== Event stream ===========\n";
+    const long iterations = 200000;
+
+    // A gather followed by undo, so every round plays the same turn
+    Game game;
+    setUpTable(game);
+    game.enableUndo();
+    Player* current = game.turn();
+
+    std::vector<std::string> log;
+    log.reserve(16);
+    auto textTurn = [&](long) {
+        game.handleTurnWithNoTarget(current, ActionId::Gather, log);
+        game.undo();
+        benchSink = benchSink + log.size();
+        log.clear();
+    };
+    auto silentTurn = [&](long) {
+        game.handleTurnWithNoTarget(current, ActionId::Gather);
+        game.undo();
+    };
+    auto eventTurn = [&](long) {
+        game.handleTurnWithNoTarget(current, ActionId::Gather);
+        game.undo();
+        benchSink = benchSink + game.events().size();
+        game.events().clear();
+    };
+
+    double text = measure("turn with a string log", iterations, textTurn);
+    double silent = measure("turn with events off", iterations, silentTurn);
+    game.events().setEnabled(true);
+    measure("turn with events on", iterations, eventTurn);
+    game.events().setEnabled(false);
+    std::cout << "  speedup (events off vs string log): " << text / silent << "x\n";
+    countAllocations("turn with a string log", 1000, textTurn);
+    countAllocations("turn with events off", 1000, silentTurn);
+    game.events().setEnabled(true);
+    countAllocations("turn with events on", 1000, eventTurn);
+}
+
+/////////////////////////////// Replays ///////////////////////////////
+
+// Plays a random-move game of six random roles and returns its replay
+static std::vector<std::uint8_t> recordRandomGame(std::uint64_t seed) {
+    Game game(seed);
+    for (int i = 0; i < 6; ++i) game.addPlayerWithRandomRole("P" + std::to_string(i));
+    ReplayWriter writer(game);
+    game.recordTo(&writer);
+    for (int turn = 0; turn < 500 && game.winner() == nullptr; ++turn) {
+        Player* current = game.turn();
+        if (!current->onBribe()) game.handleMerchantPassive(current);
+        MoveList moves = game.legalActions(current);
+        if (moves.empty()) {
+            game.passTurn();
+            continue;
+        }
+        const Move& move = moves[game.random().below(static_cast<std::uint32_t>(moves.size()))];
+        if (move.target == NO_SEAT) game.handleTurnWithNoTarget(current, move.action);
+        else game.handleTurnWithTarget(current, move.action, game.playerAt(move.target));
+    }
+    return writer.bytes();
+}
+
+static void benchReplay() {
+    std::cout << "\n=========== Replays ===========\n";
+    const int games = 2000;
+
+    std::vector<std::vector<std::uint8_t>> replays;
+    std::size_t bytes = 0;
+    long steps = 0;
+    for (int g = 0; g < games; ++g) {
+        replays.push_back(recordRandomGame(Rng::streamSeed(1, g)));
+        bytes += replays.back().size();
+        ReplayReader reader(replays.back());
+        ReplayStep step;
+        while (reader.next(step)) ++steps;
+    }
+    std::cout << "  " << games << " games, " << steps << " steps, " << bytes << " bytes ("
+              << static_cast<double>(bytes) / steps << " bytes/step with headers)\n";
+
+    auto start = std::chrono::steady_clock::now();
+    long decoded = 0;
+    for (const std::vector<std::uint8_t>& replay : replays) {
+        ReplayReader reader(replay);
+        ReplayStep step;
+        while (reader.next(step)) decoded += step.actor;
+    }
+    double decodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    benchSink = benchSink + decoded;
+    std::cout << "  decode only: " << steps / decodeSeconds / 1e6 << " M steps/s\n";
+
+    start = std::chrono::steady_clock::now();
+    for (const std::vector<std::uint8_t>& replay : replays) {
+        ReplayReader reader(replay);
+        Game game = gameFromReplay(reader.header());
+        benchSink = benchSink + replayGame(game, reader);
+    }
+    double replaySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  replay through Game: " << steps / replaySeconds / 1e6 << " M steps/s (table setup included)\n";
+}
+
+// Records a long game: everyone gathers and bribes (so nobody reaches a forced coup) for `turns` turns
+static std::vector<std::uint8_t> recordLongGame(long turns, std::size_t keyframeInterval) {
+    Game game(1);
+    setUpTable(game);
+    ReplayWriter writer(game, keyframeInterval);
+    game.recordTo(&writer);
+    for (long turn = 0; turn < turns; ++turn) {
+        Player* current = game.turn();
+        if (!current->onBribe()) game.handleMerchantPassive(current);
+        MoveList moves = game.legalActions(current);
+        ActionId action = moves.contains(ActionId::Bribe) ? ActionId::Bribe : ActionId::Gather;
+        if (game.handleTurnWithNoTarget(current, action) != ActionResult::Ok) game.passTurn();
+    }
+    return writer.bytes();
+}
+
+static void benchKeyframes() {
+    std::cout << "\n=========== Replay keyframes ===========\n";
+    const long turns = 20000;
+    const int seeks = 2000;
+
+    for (std::size_t interval : {0, 1024, 256, 64, 16}) {
+        std::vector<std::uint8_t> replay = recordLongGame(turns, interval);
+        ReplayReader reader(replay);
+        Game game = gameFromReplay(reader.header());
+        reader.seek(game, 0); // Builds the keyframe index
+        Rng rng(interval);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < seeks; ++i) benchSink = benchSink + reader.seek(game, rng.below(turns));
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / seeks;
+        std::cout << "  keyframe every " << std::setw(4) << interval << " steps: " << std::setw(7) << replay.size()
+                  << " bytes, random seek " << us << " us\n";
+    }
+}
+
+/////////////////////////////// Replay archives ///////////////////////////////
+
+static void benchArchive() {
+    std::cout << "\n=========== Replay archive scan ===========\n";
+    const int games = 20000;
+    const char* path = "bench_archive.bin";
+
+    {
+        ArchiveWriter writer(path);
+        for (int g = 0; g < games; ++g) {
+            std::vector<std::uint8_t> replay = recordRandomGame(Rng::streamSeed(2, g));
+            writer.add(replay.data(), replay.size());
+        }
+    }
+    ReplayArchive archive(path);
+
+    // Counts the Coup steps of a range - what a nightly job would do per game
+    auto scan = [](const ArchiveRange& range) {
+        long coups = 0;
+        for (const ReplayView& game : range) {
+            for (const ReplayStep& step : game.steps()) coups += step.action == ActionId::Coup;
+        }
+        return coups;
+    };
+
+    long steps = 0;
+    for (const ReplayView& game : archive.all()) steps += std::distance(game.steps().begin(), game.steps().end());
+    std::cout << "  " << archive.games() << " games, " << steps << " steps, " << archive.all().bytes() << " bytes\n";
+
+    countAllocations("scan the whole archive", 1, [&](long) { benchSink = benchSink + scan(archive.all()); });
+    for (unsigned threads : {1u, 2u, 4u}) {
+        std::vector<ArchiveRange> ranges = archive.partition(threads);
+        std::vector<long> coups(ranges.size());
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+        for (std::size_t r = 0; r < ranges.size(); ++r) {
+            pool.emplace_back([&, r]() { coups[r] = scan(ranges[r]); });
+        }
+        for (std::thread& worker : pool) worker.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (long c : coups) benchSink = benchSink + c;
+        std::cout << "  " << threads << " thread(s): " << steps / seconds / 1e6 << " M steps/s, "
+                  << archive.all().bytes() / seconds / (1 << 20) << " MB/s\n";
+    }
+    std::remove(path);
+}
+
+/////////////////////////////// Active players ///////////////////////////////
+
+static void benchActivePlayers() {
+    std::cout << "\n=========== Active players ===========\n";
+    const long iterations = 5000000;
+
+    Game game;
+    setUpTable(game);
+    game.playerAt(2)->eliminate(); // One seat is out, so the view has something to skip
+
+    measure("getPlayers().size()", iterations, [&](long) { benchSink = benchSink + game.getPlayers().size(); });
+    measure("activeCount()", iterations, [&](long) { benchSink = benchSink + game.activeCount(); });
+    auto copied = [&](long) {
+        for (Player* p : game.getPlayers()) benchSink = benchSink + p->coins();
+    };
+    auto viewed = [&](long) {
+        for (Player* p : game.activePlayers()) benchSink = benchSink + p->coins();
+    };
+    measure("loop over getPlayers()", iterations, copied);
+    measure("loop over activePlayers()", iterations, viewed);
+    countAllocations("loop over getPlayers()", 1000, copied);
+    countAllocations("loop over activePlayers()", 1000, viewed);
+}
+
+/////////////////////////////// Seat masks ///////////////////////////////
+
+static void benchSeatMasks() {
+    std::cout << "\n=========== Seat masks ===========\n";
+    const long iterations = 5000000;
+
+    Game game;
+    setUpTable(game);
+    for (std::uint8_t seat : {1, 2, 4}) game.playerAt(seat)->eliminate(); // Every turn change skips eliminated seats
+
+    measure("nextTurn() over a half-empty table", iterations, [&](long) { game.nextTurn(); });
+    measure("winner()", iterations, [&](long) { benchSink = benchSink + (game.winner() != nullptr); });
+
+    // A chain of players on coup trial, all eliminated by one turn() call
+    Game trials;
+    setUpTable(trials);
+    const GameState start = trials.state();
+    measure("turn() eliminating five players on trial", iterations / 10, [&](long) {
+        trials.loadState(start);
+        for (std::uint8_t seat = 0; seat < 5; ++seat) trials.playerAt(seat)->deactivate();
+        benchSink = benchSink + trials.turn()->seatIndex();
+    });
+}
+
+/////////////////////////////// Large tables ///////////////////////////////
+
+// Average time of one turn on tables of growing size (sizes above COUP_MAX_SEATS are skipped - see make bench-large).
+// Scripted play keeps the moves cheap: coup the next active seat with 7 coins, otherwise tax (gather / pass when refused).
+static void benchLargeTables() {
+    std::cout << "\n=========== Turn latency by table size (COUP_MAX_SEATS = " << MAX_PLAYERS << ") ===========\n";
+    const long turns = 2000000;
+
+    for (std::size_t seats : {6, 50, 100, 250, 500}) {
+        if (seats > MAX_PLAYERS) continue;
+        Game game(seats);
+        for (std::size_t seat = 0; seat < seats; ++seat) game.addPlayerWithRandomRole("P" + std::to_string(seat + 1));
+        const GameState start = game.state(); // Restored whenever a game ends
+
+        long games = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (long turn = 0; turn < turns; ++turn) {
+            Player* current = game.turn();
+            if (game.winner()) {
+                game.loadState(start);
+                ++games;
+                continue;
+            }
+            ActionResult result;
+            if (current->coins() >= 7) {
+                Player* target = game.playerAt(nextSeat(game.state().active_seats, game.state().current_turn));
+                result = game.handleTurnWithTarget(current, ActionId::Coup, target);
+            } else {
+                result = game.handleTurnWithNoTarget(current, ActionId::Tax);
+            }
+            if (result != ActionResult::Ok && game.handleTurnWithNoTarget(current, ActionId::Gather) != ActionResult::Ok) game.passTurn();
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / turns;
+        std::cout << "  " << seats << " seats: " << ns << " ns/turn (" << games << " games finished)\n";
+    }
+
+    // What the simulator and the bot do on a full table: random legal moves, one listed move set, one MCTS move
+    std::cout << "  sizeof(Game) = " << sizeof(Game) << " B, sizeof(MoveList) = " << sizeof(MoveList) << " B\n";
+    for (std::size_t seats : {6, 512, 4096}) {
+        if (seats > MAX_PLAYERS) continue;
+        Game game(seats);
+        for (std::size_t seat = 0; seat < seats; ++seat) game.addPlayerWithRandomRole("P" + std::to_string(seat + 1));
+        const GameState start = game.state();
+
+        const long moves = 1000000;
+        auto t0 = std::chrono::steady_clock::now();
+        for (long turn = 0; turn < moves; ++turn) {
+            Player* current = game.turn();
+            if (game.winner()) {
+                game.loadState(start);
+                continue;
+            }
+            if (!current->onBribe()) game.handleMerchantPassive(current);
+            const Move move = game.randomLegalAction(current, game.random());
+            if (move.action == ActionId::Count) game.passTurn();
+            else if (move.target == NO_SEAT) game.handleTurnWithNoTarget(current, move.action);
+            else game.handleTurnWithTarget(current, move.action, game.playerAt(move.target));
+        }
+        double randomNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / moves;
+
+        game.loadState(start);
+        for (Player* p : game.activePlayers()) p->addCoins(3);
+        const long lists = seats > 512 ? 2000 : 200000;
+        t0 = std::chrono::steady_clock::now();
+        for (long i = 0; i < lists; ++i) benchSink = benchSink + static_cast<long>(game.legalActions(game.turn()).size());
+        double listNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / lists;
+
+        MctsConfig config;
+        config.iterations = 1000;
+        MctsBot bot(config);
+        const std::size_t bytesBefore = allocatedBytes;
+        bot.chooseMove(game);
+        std::cout << "  " << seats << " seats: random legal move " << randomNs << " ns/turn, legalActions " << listNs
+                  << " ns, MCTS move (1000 playouts) " << bot.lastStats().milliseconds << " ms, "
+                  << (allocatedBytes - bytesBefore) / 1024 << " KB allocated\n";
+    }
+}
+
+/////////////////////////////// Rule tables ///////////////////////////////
+
+// Average time of one random legal move on a six-seat table playing by `rules` (the table restarts when someone wins)
+static double randomMoveNs(const RuleTable& rules, long turns) {
+    Game game(7);
+    game.setRules(rules);
+    setUpTable(game);
+    const GameState start = game.state();
+    auto t0 = std::chrono::steady_clock::now();
+    for (long turn = 0; turn < turns; ++turn) {
+        Player* current = game.turn();
+        if (game.winner()) {
+            game.loadState(start);
+            continue;
+        }
+        if (!current->onBribe()) game.handleMerchantPassive(current);
+        MoveList moves = game.legalActions(current);
+        if (moves.empty()) {
+            game.passTurn();
+            continue;
+        }
+        const Move& move = moves[game.random().below(static_cast<std::uint32_t>(moves.size()))];
+        if (move.target == NO_SEAT) game.handleTurnWithNoTarget(current, move.action);
+        else game.handleTurnWithTarget(current, move.action, game.playerAt(move.target));
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / turns;
+}
+
+// Rules file parse time, and the built-in rules against the same rules loaded from Rules/standard.rules
+// (best of several interleaved rounds - both play the exact same games)
+static void benchRules() {
+    std::cout << "\n=========== Rule tables ===========\n";
+    const char* path = "Rules/standard.rules";
+    RuleTable loaded;
+    try {
+        loaded = loadRules(path);
+    }
+    catch (const std::exception& e) {
+        std::cout << "  skipped: " << e.what() << " (run from the repository root)\n";
+        return;
+    }
+    measure("loadRules(Rules/standard.rules)", 2000, [&](long) { benchSink = benchSink + loadRules(path).forcedCoupCoins; });
+
+    const long turns = 2000000;
+    double builtIn = 1e9, fromFile = 1e9;
+    for (int round = 0; round < 5; ++round) {
+        builtIn = std::min(builtIn, randomMoveNs(defaultRules(), turns));
+        fromFile = std::min(fromFile, randomMoveNs(loaded, turns));
+    }
+    std::cout << "  random move, built-in rules: " << builtIn << " ns/op\n";
+    std::cout << "  random move, rules file:     " << fromFile << " ns/op (" << std::showpos << 100.0 * (fromFile - builtIn) / builtIn
+              << std::noshowpos << "%)\n";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+static const Benchmark BENCHMARKS[] = {
+    {"dispatch", benchActionDispatch},
+    {"roles", benchRoleChecks},
+    {"specials", benchRoleSpecials},
+    {"clone", benchClone},
+    {"legal", benchLegalMoves},
+    {"errors", benchIllegalMoves},
+    {"hash", benchHashing},
+    {"random", benchRandom},
+    {"mcts", benchMcts},
+    {"events", benchEvents},
+    {"replay", benchReplay},
+    {"keyframes", benchKeyframes},
+    {"archive", benchArchive},
+    {"active", benchActivePlayers},
+    {"seats", benchSeatMasks},
+    {"large", benchLargeTables},
+    {"rules", benchRules},
+};
+
+// Usage: ./bench [name...] - runs every benchmark when no name is given
+int main(int argc, char** argv) {
+    for (const Benchmark& b : BENCHMARKS) {
+        bool selected = (argc == 1);
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], b.name) == 0) selected = true;
+        }
+        if (selected) b.run();
+    }
+    return 0;
+}
@@ -3,13 +3,17 @@
 #include "Headers/Game.hpp"
 #include "Headers/Player.hpp"
 #include "Headers/PlayerFactory.hpp"
+#include "Headers/MctsBot.hpp"
+#include "Headers/Simulator.hpp"
 
 #include <iostream>
 #include <vector>
 #include <string>
-#include <map>
 #include <cstdlib>
-#include <ctime>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <random>
 
 using namespace coup;
 
@@ -19,117 +23,159 @@ void printLog(const std::vector<std::string>& log) {
         std::cout << " • " << entry << "\n";
 }
 
-Player* getRandomTarget(Player* attacker, const std::vector<Player*>& players) {
-    std::vector<Player*> candidates;
-    
-    // Filter out the attacker
-    for (Player* p : players) {
-        if (p != attacker && p->isActive()) {
-            candidates.push_back(p);
-        }
+// Handles a randomized action selection and execution (picks one of the legal moves, so nothing has to be retried)
+void randomTurn(Game& game, Player* current, std::vector<std::string>& log) {
+    const Move move = game.randomLegalAction(current, game.random());
+    if (move.action == ActionId::Count) {
+        game.passTurn(log);
+        return;
     }
 
-    // If no valid targets, return nullptr
-    if (candidates.empty()) return nullptr;
-
-    // Pick one randomly
-    int index = rand() % candidates.size();
-    return candidates[index];
+    if (move.target == NO_SEAT) {
+        game.handleTurnWithNoTarget(current, move.action, log);
+    } else {
+        game.handleTurnWithTarget(current, move.action, game.playerAt(move.target), log);
+    }
 }
 
-void filterMoves(Player* current, std::vector<std::string>& actions) {
+// Name of the rules a batch plays by (its variant, or "a rules file")
+std::string rulesName(const SimConfig& config) {
+    const std::size_t variant = config.rules ? variantOf(*config.rules) : 0;
+    return variant < RULE_VARIANT_COUNT ? ruleVariantName(variant) : "a rules file";
+}
 
-    // If a player has at least 10 coins - delete all options except coup
-    if(current->coins() >= 10 )
-    {
-        for (size_t i = 0; i < actions.size(); ) {
-            if (actions[i] == "Coup") { 
-                actions.erase(actions.begin() + i);
-            } else {
-                ++i;  // Only increment if we didn't erase
-            }
-        }
+// Prints the aggregated results of a simulation batch
+void printSimulation(const SimConfig& config, const SimResult& result) {
+    std::cout << "Simulated " << result.games << " games of " << config.players << " players in " << result.seconds << " s ("
+              << static_cast<long>(result.gamesPerSecond()) << " games/s) with " << rulesName(config) << "\n";
+    long finished = result.games - result.unfinished;
+    std::cout << "Unfinished games (over " << config.maxTurns << " actions): " << result.unfinished << "\n";
+    if (finished > 0) {
+        std::cout << "Game length (actions): avg " << static_cast<double>(result.totalTurns) / finished
+                  << ", min " << result.shortestGame << ", max " << result.longestGame << "\n";
     }
 
-    // Delete options due to lack of money - bribe = 4 , sanction = 3 , coup = 7
-    if(current->coins() < 10 )
-    {
-        for (size_t i = 0; i < actions.size(); ) {
-            const std::string& action = actions[i];
-
-            if ((action == "Bribe" && current->coins() < 4) ||
-                (action == "Sanction" && current->coins() < 3) ||
-                (action == "Coup" && current->coins() < 7)) {
-                actions.erase(actions.begin() + i);
-            } else {
-                ++i;
-            }
-        }
+    std::cout << "\nWins per role:\n";
+    for (std::size_t i = 0; i < ROLE_COUNT; ++i) {
+        double rate = result.seatsByRole[i] > 0 ? 100.0 * result.winsByRole[i] / result.seatsByRole[i] : 0;
+        std::cout << " - " << std::left << std::setw(9) << roleName(static_cast<RoleId>(i)) << std::right << std::setw(10) << result.winsByRole[i]
+                  << " wins  " << std::fixed << std::setprecision(2) << rate << "% of seats played\n" << std::defaultfloat;
     }
-}
 
-// Handles a randomized action selection and execution
-void randomTurn(Game& game, Player* current, std::vector<std::string>& log, const std::vector<Player*>& players) {
-    std::string role = current->role();
-    std::string name = current->getName();
-
-    // Generic actions for all roles
-    std::vector<std::string> generic = {"Gather", "Tax", "Bribe","Arrest","Coup","Sanction"};
-
-    // Special actions mapped by role
-    std::map<std::string, std::vector<std::string>> roleActions = {
-        {"Spy", {"BlockArrest"}},
-        {"Governor", {"BlockTax"}},
-        {"Judge", {"BlockBribe"}},
-        {"General", {"BlockCoup"}},
-        {"Baron", {"Invest"}},
-        {"Merchant", {}}
-    };
-
-    // Merge generic and special for this role
-    std::vector<std::string> actions = generic;
-    if (roleActions.count(role)) {
-        actions.insert(actions.end(), roleActions[role].begin(), roleActions[role].end());
+    std::cout << "\nWins per seat:\n";
+    for (int seat = 0; seat < config.players; ++seat) {
+        std::cout << " - Seat " << seat + 1 << ": " << result.winsBySeat[seat] << "\n";
     }
 
-    filterMoves(current,actions); // Helper function that makes random choices "smarter"
-
-    // Shuffle & pick one
-    std::string action = actions[rand() % actions.size()];
+    std::cout << "\nActions played:\n";
+    for (std::size_t i = 0; i < ACTION_COUNT; ++i) {
+        std::cout << " - " << std::left << std::setw(12) << actionName(static_cast<ActionId>(i)) << std::right << result.actionCounts[i] << "\n";
+    }
+    std::cout << " - Pass        " << result.passes << "\n";
+}
 
-    try {
-        if (action == "Gather" || action == "Tax" || action == "Bribe" || action == "Invest") {
-            game.handleTurnWithNoTarget(current, action, log);
-        } else {
-            Player* target = getRandomTarget(current, players);
-            if (!target) {
-                log.push_back(name + " wanted to use " + action + " but no target was available.");
-                return;
+// Headless batch mode: ./demo --simulate N [--players P] [--roles Spy,Judge,...] [--threads T] [--seed S] [--max-turns M]
+//                                          [--rules FILE | --variant NAME]
+int runSimulator(int argc, char** argv) {
+    SimConfig config;
+    RuleTable rules = defaultRules(); // Rules file (--rules), parsed once before the batch starts
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+        std::string value = argv[++i];
+        if (arg == "--simulate") config.games = std::stol(value);
+        else if (arg == "--players") config.players = std::stoi(value);
+        else if (arg == "--threads") config.threads = static_cast<unsigned>(std::stoul(value));
+        else if (arg == "--seed") config.seed = std::stoull(value);
+        else if (arg == "--max-turns") config.maxTurns = std::stoi(value);
+        else if (arg == "--rules") {
+            rules = loadRules(value);
+            config.rules = &rules;
+        }
+        else if (arg == "--variant") { // A compiled variant of Rules.hpp (StandardRules, QuickCoupRules, ...)
+            std::size_t variant = 0;
+            if (!parseRuleVariant(value, variant)) throw std::invalid_argument("Unknown rules variant: " + value);
+            config.rules = &variantRules(variant);
+        }
+        else if (arg == "--roles") {
+            std::stringstream list(value);
+            std::string name;
+            while (std::getline(list, name, ',')) {
+                RoleId role;
+                if (!parseRole(name, role)) throw std::invalid_argument("Invalid role: " + name);
+                config.roles.push_back(role);
             }
-            game.handleTurnWithTarget(current, action, target, log);
         }
-    } catch (const std::exception& e) {
-        log.push_back("Error: " + name + "'s action " + action + " failed: " + e.what());
+        else throw std::invalid_argument("Unknown option: " + arg);
+    }
+    if (!config.roles.empty() && config.players != static_cast<int>(config.roles.size())) {
+        config.players = static_cast<int>(config.roles.size()); // The role list decides the table size
     }
-}
-
 
-Player* isSomeoneOnCoupTrial(Game game) {
-    for (Player* p : game.getPlayers())
-        {
-            if ( p->onCoupTrial())
-                return p;
-        }
-    return nullptr;
+    printSimulation(config, runSimulation(config));
+    return 0;
 }
 
+// Checks a recorded game step by step and prints how it ended: ./demo --replay FILE [--rules FILE | --variant NAME]
+int runReplay(const std::string& path, const std::string& rulesOption, const std::string& rulesValue) {
+    RuleTable rules = defaultRules(); // Rules file the game was played by (--rules)
+    const RuleTable* played = nullptr;
+    if (rulesOption == "--rules") {
+        rules = loadRules(rulesValue);
+        played = &rules;
+    }
+    else if (rulesOption == "--variant") {
+        std::size_t variant = 0;
+        if (!parseRuleVariant(rulesValue, variant)) throw std::invalid_argument("Unknown rules variant: " + rulesValue);
+        played = &variantRules(variant);
+    }
+    else if (!rulesOption.empty()) throw std::invalid_argument("Unknown option: " + rulesOption);
+
+    std::vector<std::uint8_t> bytes = loadReplay(path);
+    ReplayReader reader(bytes);
+    Game game = gameFromReplay(reader.header(), played);
+    long steps = replayGame(game, reader);
+    std::cout << "Replayed " << steps << " steps (" << bytes.size() << " bytes) of the game with seed " << game.seed() << "\n";
+    for (Player* p : game.activePlayers()) {
+        std::cout << " - " << p->getName() << " (" << p->role() << ") - Coins: " << p->coins() << "\n";
+    }
+    return 0;
+}
 
+// Usage: ./demo [--seed S] [--record FILE] - one game (a fresh seed each run unless given, the seed replays the game),
+//                                            --record saves its binary replay
+//        ./demo --replay FILE [--rules FILE] - checks a recorded game (see runReplay)
+//        ./demo --simulate N ... - headless batch mode (see runSimulator)
+int main(int argc, char** argv) {
+    if ((argc == 3 || argc == 5) && std::strcmp(argv[1], "--replay") == 0) {
+        try {
+            return runReplay(argv[2], argc == 5 ? argv[3] : "", argc == 5 ? argv[4] : "");
+        } catch (const std::exception& e) {
+            std::cerr << "Replay error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
+    const char* seedArg = nullptr;
+    const char* recordPath = nullptr;
+    bool single = (argc % 2 == 1);
+    for (int i = 1; i + 1 < argc && single; i += 2) {
+        if (std::strcmp(argv[i], "--seed") == 0) seedArg = argv[i + 1];
+        else if (std::strcmp(argv[i], "--record") == 0) recordPath = argv[i + 1];
+        else single = false;
+    }
+    if (!single) {
+        try {
+            return runSimulator(argc, argv);
+        } catch (const std::exception& e) {
+            std::cerr << "Simulator error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
 
-
-int main() {
     try {
-        Game game;
+        std::uint64_t seed = seedArg ? std::stoull(seedArg) : std::random_device{}();
+        Game game(seed); // Roles, the bot and the random players all draw from the game's generator
         std::vector<std::string> log;
 
         game.addPlayerWithRandomRole("Alice");
@@ -141,50 +187,63 @@ int main() {
 
         std::vector<Player*> Players_list = game.getPlayers();
 
+        ReplayWriter recording(game); // Every state-changing call of the game (saved with --record)
+        game.recordTo(&recording);
+
+        // Alice is played by the MCTS bot, everyone else picks random legal moves
+        MctsConfig config;
+        config.iterations = 500;
+        MctsBot bot(config);
+        Player* botPlayer = Players_list[0];
+
+        std::cout << "Starting Game with 6 Players (replay with ./demo --seed " << seed << "):\n";
 
-        std::cout << "Starting Game with 6 Players:\n";
-        
         for (Player* p : Players_list)
         {
-            std::cout << " - " << p->getName() << " (" << p->role() << ")\n";
+            std::cout << " - " << p->getName() << " (" << p->role() << ")" << (p == botPlayer ? " [MCTS bot]" : "") << "\n";
         }
-        
-
-
 
         int round = 0;
-        while (round < 60 && game.getPlayers().size() > 1) {
+        while (round < 60 && game.activeCount() > 1) {
             Player* current = game.turn();
             std::string name = current->getName();
             std::string role = current->role();
             std::cout << "\n--- Round " << round + 1 << ": " << name << " (" << role << ") — Coins: " << current->coins() << " ---\n";
 
-
             while (current == game.turn()) {
-                randomTurn(game, current, log, game.getPlayers());
+                if (current == botPlayer) {
+                    bot.playTurn(game, log);
+                    log.push_back("(MCTS bot: " + std::to_string(bot.lastStats().playouts) + " playouts, " +
+                        std::to_string(static_cast<long>(bot.lastStats().playoutsPerSecond())) + " playouts/s)");
+                } else {
+                    randomTurn(game, current, log);
+                }
             }
 
-
             // Print the logs for this round
             printLog(log);
             // Clear for next round
             log.clear();
-            
+
             game.checkElimination(log);
-            
+
             round++;
         }
 
         // Print final results
         std::cout << "\n==================================================================================\n";
         std::cout << "\n Final Player States:\n";
-        for (Player* p : game.getPlayers()) {
+        for (Player* p : game.activePlayers()) {
             std::cout << " - " << p->getName() << " (" << p->role() << ") - Coins: " << p->coins() << "\n";
         }
 
-        
         std::cout << "\n Game ended.\n";
 
+        if (recordPath) {
+            recording.save(recordPath);
+            std::cout << " Replay saved to " << recordPath << " (" << recording.steps() << " steps, " << recording.bytes().size() << " bytes)\n";
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
     }
@@ -2,7 +2,19 @@
 #include "doctest.h"
 #include "../Headers/Game.hpp"
 #include "../Headers/PlayerFactory.hpp"
+#include "../Headers/MctsBot.hpp"
+#include "../Headers/Simulator.hpp"
+#include "../Headers/ReplayArchive.hpp"
+#include <algorithm>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+#ifndef COUP_SOURCE_DIR
+#define COUP_SOURCE_DIR "." // Root of the repo (the Makefile passes it, so the tests find Rules/ from any directory)
+#endif
 
 
 /* Disclaimer: Due to the nature of this project, testing actions and game flow without the GUI is not intuitive.
@@ -43,6 +55,36 @@ void printLog(std::vector<std::string>& log) {
     log.clear();
 }
 
+// Plays random legal moves through the event entry points (merchant coins, passes, coup eliminations and,
+// if blockCoups, Generals paying to block every coup)
+void playRandomGame(Game& game, int turns, bool blockCoups) {
+    for (int turn = 0; turn < turns && game.winner() == nullptr; ++turn) {
+        Player* current = game.turn();
+        if (!current->onBribe()) game.handleMerchantPassive(current);
+        MoveList moves = game.legalActions(current);
+        if (moves.empty()) {
+            game.passTurn();
+            continue;
+        }
+        const Move& move = moves[game.random().below(static_cast<std::uint32_t>(moves.size()))];
+        if (move.target == NO_SEAT) game.handleTurnWithNoTarget(current, move.action);
+        else game.handleTurnWithTarget(current, move.action, game.playerAt(move.target));
+        if (move.action == ActionId::Coup && blockCoups) {
+            for (Player* p : game.getPlayers()) {
+                if (p->roleId() == RoleId::General && p != current) game.handleBlockConsequences(ActionId::Coup, p, current);
+            }
+        }
+    }
+    game.turn();
+}
+
+// Seat mask with the given seats
+SeatMask maskOf(std::initializer_list<Seat> seats) {
+    SeatMask mask{};
+    for (Seat seat : seats) addSeat(mask, seat);
+    return mask;
+}
+
 
 
 TEST_CASE("Game restrictions on players") {
@@ -54,15 +96,18 @@ TEST_CASE("Game restrictions on players") {
 
 
 
+    // Large-table builds (COUP_MAX_SEATS) fill the remaining seats first
+    for (std::size_t seat = 6; seat < MAX_PLAYERS; ++seat) game.addPlayerWithRole("Extra " + std::to_string(seat), "Spy");
+
     // Now lets try to add the seventh player
     std::cout << "\n=========== Test player number limit ===========\n";
     CHECK_THROWS(game.addPlayerWithRole("Leonardo","Spy"));
     printLog(log);
-    CHECK_FALSE(game.getPlayers().size() == 7);
+    CHECK_FALSE(game.getPlayers().size() == MAX_PLAYERS + 1);
 
     // Check number of players in the game
     std::vector<Player*> players = game.getPlayers();
-    CHECK(players.size() == 6);
+    CHECK(players.size() == MAX_PLAYERS);
     
     // Check turn start
     Player* current = game.turn();
@@ -128,7 +173,7 @@ TEST_CASE("Test Gather") {
     std::cout << "\n=========== Test Gather ===========\n";
     game.handleTurnWithNoTarget(current,"Gather", log);
     printLog(log);
-    CHECK(current->coins() == 1);
+    CHECK(current->coins() == Rules::GATHER_GAIN);
 
 
 
@@ -150,10 +195,10 @@ TEST_CASE("Test Tax") {
     printLog(log);
     if (current->role() == "Governor")
     {
-        CHECK(current->coins() == 3);
+        CHECK(current->coins() == Rules::GOVERNOR_TAX_GAIN);
     }
     else
-        CHECK(current->coins() == 2);
+        CHECK(current->coins() == Rules::TAX_GAIN);
     
     ///////////////////////////////////////////////
     std::cout << "\nTest Tax - Tax block case:\n";
@@ -182,7 +227,7 @@ TEST_CASE("Test Tax") {
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
 
-    CHECK(current->coins() == 1); // Only gain 1 coin after Gather
+    CHECK(current->coins() == Rules::GATHER_GAIN); // Only gain 1 coin after Gather
     CHECK_FALSE(current == game.turn()); // Now turn should change
 
 
@@ -211,7 +256,7 @@ TEST_CASE("Test Sanction") {
         anotherPlayer = getPlayerWithMatchingRole(game,"General");
     }
 
-    current->addCoins(3); // Add 3 coins for the sanction use
+    current->addCoins(Rules::SANCTION_COST); // Add 3 coins for the sanction use
 
     
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
@@ -245,7 +290,7 @@ TEST_CASE("Test Sanction") {
     }
 
 
-    current->addCoins(3); // Add 3 coins for the sanction use
+    current->addCoins(Rules::SANCTION_COST); // Add 3 coins for the sanction use
     CHECK(anotherPlayer->coins() == 0); // Should have 0 coins on start
 
 
@@ -266,7 +311,7 @@ TEST_CASE("Test Sanction") {
 
     if (anotherPlayer->role() == "Baron") // Baron should get 1 coin compensation
     {
-        CHECK(anotherPlayer->coins() == 1);
+        CHECK(anotherPlayer->coins() == Rules::BARON_SANCTION_REFUND);
     }
     else
         CHECK(current->coins() == 2);
@@ -295,7 +340,7 @@ TEST_CASE("Test Bribe") {
     Player* current = game.turn();
 
 
-    current->addCoins(3); // Add 3 coins for the bribe use
+    current->addCoins(Rules::BRIBE_COST - 1); // One coin short of the bribe
 
     
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
@@ -326,7 +371,7 @@ TEST_CASE("Test Bribe") {
     // Get pointers to current player and some target
     current = game.getPlayers()[2];
 
-    current->addCoins(4); // Add 4 coins for the bribe use
+    current->addCoins(Rules::BRIBE_COST); // Add 4 coins for the bribe use
 
     
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
@@ -375,7 +420,7 @@ TEST_CASE("Test Arrest") {
 
     std::cout << "\nSpy is trying to arrest Governor: \n";
     // We will artificially add coins to the Governor
-    target->addCoins(1);
+    target->addCoins(Rules::ARREST_STEAL);
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
     std::cout << "Target player `" << target->getName() << "` has " << target->coins() << " coins\n";
@@ -395,7 +440,7 @@ TEST_CASE("Test Arrest") {
     std::cout << "\nGovernor is trying to arrest General: \n";
 
     // We will artificially add coins to the General
-    target->addCoins(1);
+    target->addCoins(Rules::ARREST_STEAL);
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
     std::cout << "Target player `" << target->getName() << "` has " << target->coins() << " coins\n";
@@ -415,7 +460,7 @@ TEST_CASE("Test Arrest") {
     std::cout << "\nGeneral is trying to arrest Merchant: \n";
 
     // We will artificially add coins to the Merchant
-    target->addCoins(2);
+    target->addCoins(Rules::MERCHANT_ARREST_LOSS);
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
     std::cout << "Target player `" << target->getName() << "` has " << target->coins() << " coins\n";
@@ -454,7 +499,7 @@ TEST_CASE("Test Arrest") {
     
     // Now we will make an attempt to use arrest with joey
     target = game.getPlayers()[5]; // Target is now arthur (Judge)
-    target->addCoins(1);
+    target->addCoins(Rules::ARREST_STEAL);
     current = game.turn();
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
@@ -490,7 +535,7 @@ TEST_CASE("Test coup") {
 
     std::cout << "\nSpy is trying to coup Governor: \n";
     // We will artificially add coins to the Spy (Dexter)
-    current->addCoins(7);
+    current->addCoins(Rules::COUP_COST);
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
     std::cout << "Target player `" << target->getName() << "` has " << target->coins() << " coins\n";
@@ -515,7 +560,7 @@ TEST_CASE("Test coup") {
 
     std::cout << "\nGeneral is trying to make an action that is not 'coup' while he has 10+ coins: \n";
     // We will artificially add coins to the General (Angel)
-    current->addCoins(11);
+    current->addCoins(Rules::FORCED_COUP_COINS + 1);
 
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
     std::cout << "Target player `" << target->getName() << "` has " << target->coins() << " coins\n";
@@ -544,8 +589,8 @@ TEST_CASE("Test coup") {
     current = game.turn(); // Update current player's pointer
     target = game.getPlayers()[0]; // Should be now Spy (Dexter)
     Player* general = game.getPlayers()[1]; // Angel (General)
-    general->addCoins(5); // We will artificially add coins to the General (Angel) - needs 5 to coup block someone
-    current->addCoins(7); // We will artificially add coins to use coup on someone
+    general->addCoins(Rules::BLOCK_COUP_COST - general->coins()); // The General (Angel) gets exactly what a coup block costs (below a forced coup)
+    current->addCoins(Rules::COUP_COST); // We will artificially add coins to use coup on someone
     
     
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
@@ -590,7 +635,7 @@ TEST_CASE("Test Invest") {
 
     // We add artificially coins to Baron to use invest
     CHECK(current->role() == "Baron");
-    current->addCoins(3);
+    current->addCoins(Rules::INVEST_COST);
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
 
     game.handleTurnWithNoTarget(current,"Invest", log);
@@ -620,13 +665,13 @@ TEST_CASE("Merchant passive coin gain ability") {
         game.handleTurnWithNoTarget(current,"Gather", log);
         current = game.turn();
     }
-    current->addCoins(3); // We add artificially coins to Merchant to see the passive works
+    current->addCoins(Rules::MERCHANT_PASSIVE_COINS); // We add artificially coins to Merchant to see the passive works
     game.handleMerchantPassive(current,log); // Use the function for it
     printLog(log);
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
 
     CHECK(current->role() == "Merchant");
-    CHECK(current->coins() == 4);
+    CHECK(current->coins() == Rules::MERCHANT_PASSIVE_COINS + Rules::MERCHANT_PASSIVE_GAIN);
 
     std::cout << "\nShow that the passive does not work on less than 3 coins:\n";
 
@@ -636,7 +681,8 @@ TEST_CASE("Merchant passive coin gain ability") {
     game.handleTurnWithNoTarget(current,"Gather", log);
     printLog(log);
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
-    CHECK(current->coins() == 2);
+    const int left = Rules::MERCHANT_PASSIVE_COINS + Rules::MERCHANT_PASSIVE_GAIN - Rules::BRIBE_COST + 2 * Rules::GATHER_GAIN;
+    CHECK(current->coins() == left);
 
 
     // Run up to his turn again
@@ -648,7 +694,7 @@ TEST_CASE("Merchant passive coin gain ability") {
     game.handleMerchantPassive(current,log); // Use the function for it
     printLog(log);
     std::cout << "\nCurrent player `" << current->getName() << "` has " << current->coins() << " coins\n";
-    CHECK(current->coins() == 2);
+    CHECK(current->coins() == left);
 
 }
 
@@ -663,7 +709,7 @@ TEST_CASE("Test Winner") {
     Player* current = game.turn(); // Dexter
     Player* target = game.getPlayers()[1]; // Debra
 
-    current->addCoins(7); // Add coins artificially to make coup
+    current->addCoins(Rules::COUP_COST); // Add coins artificially to make coup
 
     CHECK(game.winner() == nullptr); // Should be still 2 players in the game - no winner
 
@@ -675,3 +721,1491 @@ TEST_CASE("Test Winner") {
     
 }
 
+
+////////////////////////// Test engine internals //////////////////////////
+
+TEST_CASE("Action table dispatch") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+
+    std::cout << "\n=========== Test action table ===========\n";
+
+    // Every action name should parse back to the same id
+    for (size_t i = 0; i < ACTION_COUNT; ++i) {
+        ActionId id = static_cast<ActionId>(i);
+        ActionId parsed;
+        CHECK(parseAction(actionName(id), parsed));
+        CHECK(parsed == id);
+    }
+    ActionId unknown;
+    CHECK_FALSE(parseAction("Steal", unknown));
+
+    // Table rows say how each action runs - its rules come from the game
+    CHECK(describe(ActionId::Coup).needsTarget);
+    CHECK_FALSE(describe(ActionId::Gather).needsTarget);
+    CHECK_FALSE(describe(ActionId::Bribe).endsTurn);
+    CHECK(game.rules().cost[static_cast<std::size_t>(ActionId::Coup)] == Rules::COUP_COST);
+    CHECK(game.rules().blockedBy[static_cast<std::size_t>(ActionId::Tax)] == RoleId::Governor);
+    CHECK(game.rules().blockedBy[static_cast<std::size_t>(ActionId::Sanction)] == RoleId::None);
+
+    // Dispatch with an id instead of a string
+    Player* current = game.turn();
+    game.handleTurnWithNoTarget(current, ActionId::Gather, log);
+    CHECK(current->coins() == Rules::GATHER_GAIN);
+    CHECK(current != game.turn());
+
+    // Unknown names and role specials of another role are reported without changing the turn
+    current = game.turn(); // Governor
+    game.handleTurnWithNoTarget(current, "Steal", log);
+    game.handleTurnWithNoTarget(current, ActionId::Invest, log);
+    game.handleTurnWithTarget(current, ActionId::BlockCoup, game.getPlayers()[0], log);
+    printLog(log);
+    CHECK(current == game.turn());
+}
+
+TEST_CASE("Role tags") {
+    Game game;
+    setUpGame(game);
+
+    std::cout << "\n=========== Test role tags ===========\n";
+
+    // Every role name should parse back to the same id
+    for (size_t i = 0; i < ROLE_COUNT; ++i) {
+        RoleId id = static_cast<RoleId>(i);
+        RoleId parsed;
+        CHECK(parseRole(roleName(id), parsed));
+        CHECK(parsed == id);
+    }
+
+    // The tag is set by the factory and the name is only a lookup
+    std::vector<Player*> players = game.getPlayers();
+    CHECK(players[0]->roleId() == RoleId::Spy);
+    CHECK(players[3]->roleId() == RoleId::Baron);
+    CHECK(players[3]->role() == "Baron");
+
+    CHECK_THROWS(game.addPlayerWithRole("Rita", "Queen")); // Unknown role name
+
+    Game other;
+    other.addPlayerWithRole("Rita", RoleId::Judge);
+    CHECK(other.getPlayers()[0]->role() == "Judge");
+}
+
+TEST_CASE("Packed game state") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+
+    std::cout << "\n=========== Test packed game state ===========\n";
+
+    if (MAX_PLAYERS == 6) CHECK(sizeof(GameState) <= 64); // A whole table fits in one cache line (large-table builds grow it)
+
+    const GameState& state = game.state();
+    CHECK(state.seat_count == 6);
+    CHECK(state.roles[2] == RoleId::General);
+    CHECK(state.last_arrested == NO_SEAT);
+
+    GameState start = game.state(); // Plain copy of the whole table
+
+    // Players are views over the state
+    Player* current = game.turn();
+    Player* target = game.getPlayers()[1];
+    target->addCoins(2);
+    game.handleTurnWithTarget(current, ActionId::Arrest, target, log);
+    CHECK(state.coins[current->seatIndex()] == current->coins());
+    CHECK(state.coins[target->seatIndex()] == 2 - Rules::ARREST_STEAL);
+    CHECK(state.last_arrested == target->seatIndex());
+    CHECK(state.current_turn == 1);
+
+    // Restoring the copy brings the table back
+    game.loadState(start);
+    CHECK(current->coins() == 0);
+    CHECK(target->coins() == 0);
+    CHECK(game.turn() == current);
+
+    // A state of another table can't be loaded
+    Game other;
+    other.addPlayerWithRole("Rita", RoleId::Judge);
+    CHECK_THROWS(game.loadState(other.state()));
+}
+
+TEST_CASE("Clone and move a game") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+
+    std::cout << "\n=========== Test clone and move ===========\n";
+
+    game.getPlayers()[0]->addCoins(3);
+
+    // The clone is a deep copy with its own players
+    Game fork = game.clone();
+    CHECK(fork.getPlayers().size() == 6);
+    CHECK(fork.getPlayers()[0] != game.getPlayers()[0]);
+    CHECK(fork.getPlayers()[0]->coins() == 3);
+    CHECK(fork.players() == game.players());
+
+    // Playing on the clone does not touch the original (the clone's players are bound to the clone)
+    fork.handleTurnWithNoTarget(fork.turn(), ActionId::Gather, log);
+    fork.handleTurnWithNoTarget(fork.turn(), ActionId::Tax, log);
+    CHECK(fork.getPlayers()[0]->coins() == 3 + Rules::GATHER_GAIN);
+    CHECK(fork.getPlayers()[1]->coins() == Rules::GOVERNOR_TAX_GAIN);
+    CHECK(game.getPlayers()[0]->coins() == 3);
+    CHECK(game.turn() == game.getPlayers()[0]);
+
+    // Moving rebuilds the same players in the new game (players live inside their game)
+    std::string first = fork.getPlayers()[0]->getName();
+    Game moved(std::move(fork));
+    CHECK(moved.getPlayers()[0]->getName() == first);
+    CHECK(moved.getPlayers()[0]->coins() == 3 + Rules::GATHER_GAIN);
+    CHECK(fork.getPlayers().empty());
+    Player* current = moved.turn();
+    moved.handleTurnWithNoTarget(current, ActionId::Gather, log);
+    CHECK(current != moved.turn()); // The player's actions run against the game it was moved into
+
+    // Assigning a fresh game (the GUI's "New Game") releases the old players once
+    game = Game();
+    CHECK(game.getPlayers().empty());
+    game = moved;
+    CHECK(game.getPlayers()[2]->coins() == Rules::GATHER_GAIN);
+    CHECK(game.getPlayers()[2] != moved.getPlayers()[2]);
+}
+
+TEST_CASE("Undo journal") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+    game.enableUndo();
+
+    std::cout << "\n=========== Test undo journal ===========\n";
+
+    std::vector<Player*> p = game.getPlayers(); // Dexter, Debra, Angel, Joey, James, Arthur
+    std::vector<GameState> history = {game.state()};
+
+    game.handleTurnWithNoTarget(p[0], ActionId::Gather, log); // Dexter
+    history.push_back(game.state());
+    game.handleTurnWithNoTarget(p[1], ActionId::Tax, log); // Debra
+    history.push_back(game.state());
+    p[2]->addCoins(Rules::COUP_COST); // Direct changes are recorded as their own entry
+    history.push_back(game.state());
+    game.handleTurnWithTarget(p[2], ActionId::Coup, p[3], log); // Angel places Joey on coup trial
+    history.push_back(game.state());
+    CHECK(game.turn() == p[4]); // Joey is eliminated when his turn comes
+    history.push_back(game.state());
+    game.handleTurnWithTarget(p[4], ActionId::Arrest, p[1], log); // James arrests Debra
+    history.push_back(game.state());
+    p[5]->addCoins(Rules::BRIBE_COST);
+    history.push_back(game.state());
+    game.handleTurnWithNoTarget(p[5], ActionId::Bribe, log); // Arthur bribes and keeps the turn
+    history.push_back(game.state());
+    game.handleTurnWithNoTarget(p[5], ActionId::Gather, log);
+    history.push_back(game.state());
+    printLog(log);
+
+    // Failed actions change nothing and record nothing
+    size_t depth = game.undoDepth();
+    game.handleTurnWithNoTarget(p[5], ActionId::Invest, log);
+    CHECK(game.undoDepth() == depth);
+    CHECK(depth == history.size() - 1);
+
+    // Walk all the way back, one action at a time
+    while (history.size() > 1) {
+        history.pop_back();
+        CHECK(game.undo());
+        CHECK(game.state() == history.back());
+    }
+    CHECK_FALSE(game.undo());
+    CHECK(p[3]->isActive()); // Joey is back in the game
+    CHECK(game.turn() == p[0]);
+}
+
+TEST_CASE("Legal move generator") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+
+    std::cout << "\n=========== Test legal moves ===========\n";
+
+    std::vector<Player*> p = game.getPlayers(); // Dexter, Debra, Angel, Joey, James, Arthur
+
+    // Opening move: Gather and Tax only (nobody has coins to arrest, no money for anything else)
+    MoveList moves = game.legalActions(p[0]);
+    CHECK(moves.size() == 7); // Gather, Tax and a block arrest on each of the 5 others
+    CHECK(moves.contains(ActionId::Gather));
+    CHECK(moves.contains(ActionId::Tax));
+    CHECK(moves.contains(ActionId::BlockArrest, 1));
+    CHECK_FALSE(moves.contains(ActionId::Arrest, 1));
+    CHECK_FALSE(moves.contains(ActionId::BlockArrest, 0)); // No self target
+    CHECK(game.legalActions(p[1]).empty()); // Not Debra's turn
+
+    // Costs and role specials
+    p[0]->addCoins(Rules::SANCTION_COST);
+    p[3]->addCoins(Rules::INVEST_COST);
+    p[4]->addCoins(Rules::MERCHANT_ARREST_LOSS - 1);
+    moves = game.legalActions(p[0]);
+    CHECK(moves.contains(ActionId::Sanction, 1));
+    CHECK_FALSE(moves.contains(ActionId::Sanction, 5)); // Sanctioning the Judge costs 4
+    CHECK(moves.contains(ActionId::Arrest, 3));
+    CHECK_FALSE(moves.contains(ActionId::Arrest, 4)); // The Merchant pays 2 coins when arrested
+    CHECK_FALSE(moves.contains(ActionId::Bribe));
+
+    // Arrest blocked, sanctioned, and the recently-arrested seat
+    game.handleTurnWithTarget(p[0], ActionId::Arrest, p[3], log); // Dexter arrests Joey
+    game.handleTurnWithTarget(p[1], ActionId::BlockArrest, p[2], log); // Debra can't block arrest
+    CHECK(game.turn() == p[1]);
+    game.handleTurnWithNoTarget(p[1], ActionId::Gather, log);
+    game.handleTurnWithNoTarget(p[2], ActionId::Gather, log);
+    moves = game.legalActions(p[3]); // Joey the Baron, short of an investment after the arrest
+    CHECK_FALSE(moves.contains(ActionId::Invest));
+    CHECK(moves.contains(ActionId::Arrest, 0));
+    p[3]->addCoins(Rules::ARREST_STEAL);
+    CHECK(game.legalActions(p[3]).contains(ActionId::Invest));
+    p[3]->addCoins(Rules::SANCTION_COST - p[3]->coins());
+    game.handleTurnWithTarget(p[3], ActionId::Sanction, p[4], log); // Joey sanctions James
+    p[4]->addCoins(Rules::BRIBE_COST);
+    p[3]->addCoins(Rules::ARREST_STEAL);
+    moves = game.legalActions(p[4]);
+    CHECK_FALSE(moves.contains(ActionId::Gather));
+    CHECK_FALSE(moves.contains(ActionId::Tax));
+    CHECK(moves.contains(ActionId::Bribe));
+    CHECK_FALSE(moves.contains(ActionId::Arrest, 3)); // Joey was arrested most recently
+    CHECK(moves.contains(ActionId::Arrest, 0));
+    game.handleTurnWithNoTarget(p[4], ActionId::Bribe, log);
+    CHECK_FALSE(game.legalActions(p[4]).contains(ActionId::Bribe)); // Only one bribe per turn
+
+    // Forced coup at 10 coins
+    Game rich;
+    setUpGame(rich);
+    std::vector<Player*> r = rich.getPlayers();
+    r[0]->addCoins(Rules::FORCED_COUP_COINS);
+    moves = rich.legalActions(r[0]);
+    CHECK(moves.size() == 5);
+    for (const Move& m : moves) CHECK(m.action == ActionId::Coup);
+    printLog(log);
+
+    // Every generated move can be played without failing, over many random games
+    srand(7);
+    for (int g = 0; g < 50; ++g) {
+        Game sim;
+        setUpGame(sim);
+        for (int turn = 0; turn < 200 && sim.winner() == nullptr; ++turn) {
+            Player* current = sim.turn();
+            MoveList legal = sim.legalActions(current);
+            if (legal.empty()) {
+                sim.nextTurn();
+                continue;
+            }
+            const Move& move = legal[rand() % legal.size()];
+            std::vector<std::string> turnLog;
+            GameState before = sim.state();
+            if (move.target == NO_SEAT) sim.handleTurnWithNoTarget(current, move.action, turnLog);
+            else sim.handleTurnWithTarget(current, move.action, sim.playerAt(move.target), turnLog);
+            REQUIRE(!turnLog.empty());
+            CHECK(turnLog[0].rfind("Action failed", 0) == std::string::npos);
+            CHECK(sim.state() != before);
+        }
+    }
+}
+
+TEST_CASE("Random legal moves without a list") {
+    std::cout << "\n=========== Test random legal moves ===========\n";
+
+    // The list walks, indexes and counts the same moves, and every drawn move is one of them
+    for (std::uint64_t seed = 1; seed <= 30; ++seed) {
+        Game game(seed);
+        setUpGame(game);
+        for (int turn = 0; turn < 200 && game.winner() == nullptr; ++turn) {
+            Player* current = game.turn();
+            MoveList legal = game.legalActions(current);
+            std::size_t walked = 0;
+            for (Move m : legal) {
+                CHECK(legal.contains(m.action, m.target));
+                CHECK((legal[walked].action == m.action && legal[walked].target == m.target));
+                ++walked;
+            }
+            CHECK(walked == legal.size());
+
+            Move coup = game.randomLegalAction(current, game.random(), ActionId::Coup);
+            if (coup.action != ActionId::Count) CHECK(legal.contains(ActionId::Coup, coup.target));
+            Move move = game.randomLegalAction(current, game.random());
+            if (move.action == ActionId::Count) {
+                CHECK(legal.empty());
+                game.passTurn();
+                continue;
+            }
+            REQUIRE(legal.contains(move.action, move.target));
+            if (move.target == NO_SEAT) CHECK(game.handleTurnWithNoTarget(current, move.action) == ActionResult::Ok);
+            else CHECK(game.handleTurnWithTarget(current, move.action, game.playerAt(move.target)) == ActionResult::Ok);
+        }
+    }
+
+    // Uniform over the legal moves - draws of a six-seat turn land evenly on every move
+    Game game(3);
+    setUpGame(game);
+    game.turn()->addCoins(5);
+    MoveList legal = game.legalActions(game.turn());
+    std::vector<int> hits(legal.size());
+    const int draws = 40000;
+    for (int i = 0; i < draws; ++i) {
+        Move move = game.randomLegalAction(game.turn(), game.random());
+        for (std::size_t m = 0; m < legal.size(); ++m) {
+            if (legal[m].action == move.action && legal[m].target == move.target) hits[m]++;
+        }
+    }
+    const double expected = static_cast<double>(draws) / legal.size();
+    for (int h : hits) CHECK((h > expected * 0.8 && h < expected * 1.2));
+
+    // A full table: one seat mask per targeted action instead of a move per target
+    Game full;
+    for (std::size_t seat = 0; seat < MAX_PLAYERS; ++seat) {
+        full.addPlayerWithRole("P" + std::to_string(seat + 1), "Spy");
+        full.playerAt(seat)->addCoins(Rules::ARREST_STEAL); // Everyone can be arrested
+    }
+    MoveList spyMoves = full.legalActions(full.turn());
+    CHECK(spyMoves.size() == 2 + 2 * (MAX_PLAYERS - 1)); // Gather, Tax, and Arrest and BlockArrest on every other seat
+    CHECK(spyMoves.contains(ActionId::BlockArrest, static_cast<Seat>(MAX_PLAYERS - 1)));
+    CHECK(sizeof(MoveList) <= 32 + MoveList::TARGETED_ACTIONS * sizeof(SeatMask));
+}
+
+TEST_CASE("Action results without exceptions") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+
+    std::cout << "\n=========== Test action results ===========\n";
+
+    std::vector<Player*> p = game.getPlayers(); // Dexter, Debra, Angel, Joey, James, Arthur
+
+    // Illegal moves return a reason and change nothing
+    GameState before = game.state();
+    CHECK(p[1]->tryGather() == ActionResult::NotYourTurn);
+    CHECK(p[0]->tryArrest(*p[0]) == ActionResult::SelfTarget);
+    CHECK(p[0]->tryArrest(*p[1]) == ActionResult::TargetNotEnoughCoins);
+    CHECK(p[0]->tryBribe() == ActionResult::NotEnoughCoins);
+    CHECK(p[0]->trySanction(*p[1]) == ActionResult::NotEnoughCoins);
+    CHECK(p[0]->tryCoup(*p[1]) == ActionResult::NotEnoughCoins);
+    CHECK(p[0]->tryBlockTax(*p[1]) == ActionResult::WrongRole);
+    CHECK(game.state() == before);
+
+    // The game returns the same reasons and logs them
+    CHECK(game.handleTurnWithTarget(p[0], ActionId::Arrest, p[0], log) == ActionResult::SelfTarget);
+    CHECK(log.back() == "Action failed: Cannot perform Arrest on yourself");
+    CHECK(game.handleTurnWithNoTarget(p[0], ActionId::Invest, log) == ActionResult::WrongRole);
+    CHECK(game.handleTurnWithNoTarget(p[0], ActionId::Coup, log) == ActionResult::MissingTarget);
+    CHECK(game.handleTurnWithNoTarget(p[0], "Dance", log) == ActionResult::UnknownAction);
+    CHECK(game.state() == before);
+
+    // Legal moves
+    CHECK(game.handleTurnWithNoTarget(p[0], ActionId::Gather, log) == ActionResult::Ok);
+    CHECK(p[1]->tryTax() == ActionResult::Ok); // Governor gets 3
+    CHECK(p[1]->coins() == Rules::GOVERNOR_TAX_GAIN);
+    game.nextTurn();
+
+    // Sanction, forced coup and the recently arrested rule
+    p[2]->addCoins(Rules::SANCTION_COST);
+    CHECK(p[2]->trySanction(*p[5]) == ActionResult::NotEnoughCoins); // The Judge costs 4
+    CHECK(p[2]->trySanction(*p[3]) == ActionResult::Ok);
+    game.nextTurn();
+    CHECK(p[3]->tryGather() == ActionResult::Sanctioned);
+    CHECK(p[3]->tryArrest(*p[1]) == ActionResult::Ok);
+    game.nextTurn();
+    p[4]->addCoins(Rules::FORCED_COUP_COINS);
+    CHECK(p[4]->tryArrest(*p[0]) == ActionResult::MustCoup);
+    p[4]->deductCoins(Rules::FORCED_COUP_COINS - 2);
+    CHECK(p[4]->tryArrest(*p[1]) == ActionResult::RecentlyArrested);
+
+    // The throwing API is a wrapper over the same checks
+    CHECK_THROWS_WITH(p[4]->arrest(*p[1]), "Debra was recently arrested and cannot be arrested again yet.");
+    CHECK_THROWS_WITH(p[0]->gather(), "Not your turn");
+    CHECK_NOTHROW(p[4]->gather());
+
+    // Every result has a message
+    for (int r = 0; r <= static_cast<int>(ActionResult::UnknownAction); ++r) {
+        CHECK_FALSE(resultMessage(static_cast<ActionResult>(r), ActionId::Tax, *p[0], p[1]).empty());
+    }
+    printLog(log);
+}
+
+TEST_CASE("Zobrist hash") {
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+    game.enableUndo();
+
+    std::cout << "\n=========== Test Zobrist hash ===========\n";
+
+    std::vector<Player*> p = game.getPlayers(); // Dexter, Debra, Angel, Joey, James, Arthur
+    CHECK(Game().hash() == 0);
+    CHECK(game.hash() == zobrist::compute(game.state()));
+
+    // Every field the hash covers changes it
+    std::uint64_t start = game.hash();
+    p[2]->addCoins(1);
+    CHECK(game.hash() != start);
+    p[2]->deductCoins(1);
+    CHECK(game.hash() == start); // Same state, same hash
+    game.handleTurnWithNoTarget(p[0], ActionId::Gather, log); // Coins and turn
+    std::uint64_t afterGather = game.hash();
+    CHECK(afterGather != start);
+    p[1]->addCoins(Rules::BRIBE_COST);
+    std::uint64_t beforeBribe = game.hash();
+    game.handleTurnWithNoTarget(p[1], ActionId::Bribe, log); // Bribe state
+    CHECK(game.hash() != beforeBribe);
+    game.handleTurnWithTarget(p[1], ActionId::Arrest, p[0], log); // Recently arrested seat
+    game.handleTurnWithTarget(p[2], ActionId::BlockTax, p[3], log); // Not a Governor - nothing changes
+    std::uint64_t beforeSanction = game.hash();
+    p[2]->addCoins(Rules::SANCTION_COST);
+    game.handleTurnWithTarget(p[2], ActionId::Sanction, p[4], log); // Flags
+    CHECK(game.hash() != beforeSanction);
+    CHECK(game.hash() == zobrist::compute(game.state()));
+
+    // Undo restores the hash too
+    while (game.undo()) {}
+    CHECK(game.hash() == start);
+
+    // The same position reached in a different order hashes the same
+    Game a;
+    setUpGame(a);
+    Game b;
+    setUpGame(b);
+    a.getPlayers()[2]->addCoins(3);
+    a.getPlayers()[4]->addCoins(2);
+    b.getPlayers()[4]->addCoins(2);
+    b.getPlayers()[2]->addCoins(3);
+    CHECK(a.hash() == b.hash());
+    CHECK(a.clone().hash() == a.hash());
+    b.loadState(a.state());
+    CHECK(b.hash() == a.hash());
+    printLog(log);
+
+    // Random games keep the incremental hash equal to a full recompute (debug builds also assert it on every change)
+    srand(11);
+    for (int g = 0; g < 20; ++g) {
+        Game sim;
+        setUpGame(sim);
+        for (int turn = 0; turn < 200 && sim.winner() == nullptr; ++turn) {
+            Player* current = sim.turn();
+            MoveList legal = sim.legalActions(current);
+            if (legal.empty()) {
+                sim.nextTurn();
+                continue;
+            }
+            const Move& move = legal[rand() % legal.size()];
+            std::vector<std::string> turnLog;
+            if (move.target == NO_SEAT) sim.handleTurnWithNoTarget(current, move.action, turnLog);
+            else sim.handleTurnWithTarget(current, move.action, sim.playerAt(move.target), turnLog);
+            REQUIRE(sim.hash() == zobrist::compute(sim.state()));
+        }
+    }
+}
+
+TEST_CASE("MCTS bot") {
+    std::cout << "\n=========== Test MCTS bot ===========\n";
+
+    // A coup wins a duel when both players can afford one
+    Game duel;
+    duel.addPlayerWithRole("Dexter", "Spy");
+    duel.addPlayerWithRole("Joey", "Baron");
+    duel.getPlayers()[0]->addCoins(Rules::COUP_COST);
+    duel.getPlayers()[1]->addCoins(Rules::COUP_COST);
+
+    MctsConfig config;
+    config.iterations = 2000;
+    MctsBot bot(config);
+    GameState before = duel.state();
+    Move move = bot.chooseMove(duel);
+    CHECK(move.action == ActionId::Coup);
+    CHECK(move.target == 1);
+    CHECK(duel.state() == before); // Searching doesn't touch the real table
+    CHECK(bot.lastStats().playouts == 2000);
+    CHECK(bot.lastStats().playoutsPerSecond() > 0);
+
+    // A wall-clock budget stops the search by itself
+    MctsConfig timed;
+    timed.iterations = 0;
+    timed.timeLimitMs = 20;
+    MctsBot timedBot(timed);
+    timedBot.chooseMove(duel);
+    CHECK(timedBot.lastStats().playouts > 0);
+    CHECK(timedBot.lastStats().milliseconds >= 20);
+
+    timed.timeLimitMs = 0;
+    CHECK_THROWS(MctsBot(timed)); // No budget at all
+
+    // The bot plays whole games through the normal API without an illegal move
+    Game game;
+    setUpGame(game);
+    std::vector<std::string> log;
+    config.iterations = 100;
+    MctsBot player(config);
+    srand(3);
+    for (int turn = 0; turn < 300 && game.winner() == nullptr; ++turn) {
+        Player* current = game.turn();
+        if (current->seatIndex() == 0) {
+            CHECK(player.playTurn(game, log) == ActionResult::Ok);
+        } else {
+            MoveList moves = game.legalActions(current);
+            if (moves.empty()) {
+                game.nextTurn();
+                continue;
+            }
+            const Move& m = moves[rand() % moves.size()];
+            if (m.target == NO_SEAT) game.handleTurnWithNoTarget(current, m.action, log);
+            else game.handleTurnWithTarget(current, m.action, game.playerAt(m.target), log);
+        }
+    }
+    for (const std::string& line : log) CHECK(line.rfind("Action failed", 0) == std::string::npos);
+    std::cout << "Bot speed: " << player.lastStats().playoutsPerSecond() << " playouts/s\n";
+}
+
+TEST_CASE("Batch simulator") {
+    std::cout << "\n=========== Test batch simulator ===========\n";
+
+    SimConfig config;
+    config.games = 400;
+    config.seed = 42;
+    config.threads = 1;
+    SimResult single = runSimulation(config);
+    config.threads = 4;
+    SimResult parallel = runSimulation(config);
+
+    // Same master seed, same results, no matter how many threads played the games
+    CHECK(single.games == 400);
+    CHECK(parallel.games == single.games);
+    CHECK(parallel.unfinished == single.unfinished);
+    CHECK(parallel.totalTurns == single.totalTurns);
+    CHECK(parallel.shortestGame == single.shortestGame);
+    CHECK(parallel.longestGame == single.longestGame);
+    CHECK(parallel.passes == single.passes);
+    for (size_t i = 0; i < ROLE_COUNT; ++i) {
+        CHECK(parallel.winsByRole[i] == single.winsByRole[i]);
+        CHECK(parallel.seatsByRole[i] == single.seatsByRole[i]);
+    }
+    for (size_t i = 0; i < ACTION_COUNT; ++i) CHECK(parallel.actionCounts[i] == single.actionCounts[i]);
+
+    // Every finished game has exactly one winner
+    long wins = 0;
+    for (size_t i = 0; i < MAX_PLAYERS; ++i) wins += single.winsBySeat[i];
+    CHECK(wins == single.games - single.unfinished);
+
+    // A different seed plays different games
+    config.seed = 43;
+    CHECK(runSimulation(config).totalTurns != single.totalTurns);
+
+    // Fixed roles per seat
+    config.players = 2;
+    config.roles = {RoleId::General, RoleId::Judge};
+    SimResult duel = runSimulation(config);
+    CHECK(duel.seatsByRole[static_cast<size_t>(RoleId::General)] == 400);
+    CHECK(duel.seatsByRole[static_cast<size_t>(RoleId::Baron)] == 0);
+    CHECK(duel.winsByRole[static_cast<size_t>(RoleId::General)] + duel.winsByRole[static_cast<size_t>(RoleId::Judge)] == duel.games - duel.unfinished);
+
+    config.roles = {RoleId::General};
+    CHECK_THROWS(runSimulation(config)); // One role per seat
+    std::cout << "Simulated " << single.games << " games at " << single.gamesPerSecond() << " games/s\n";
+}
+
+TEST_CASE("Seeded random generator") {
+    std::cout << "\n=========== Test seeded generator ===========\n";
+
+    // Same seed, same numbers; the generator is small
+    Rng a(7), b(7), c(8);
+    CHECK(a() == b());
+    CHECK(a == b);
+    CHECK(a() != c());
+    CHECK(sizeof(Rng) <= 40);
+    for (int i = 0; i < 1000; ++i) CHECK(a.below(6) < 6);
+    CHECK(Rng::streamSeed(1, 0) != Rng::streamSeed(1, 1));
+
+    // Roles come from the table's own seed
+    auto roles = [](std::uint64_t seed) {
+        Game game(seed);
+        for (int i = 0; i < 6; ++i) game.addPlayerWithRandomRole("P" + std::to_string(i));
+        std::vector<RoleId> result;
+        for (Player* p : game.getPlayers()) result.push_back(p->roleId());
+        return result;
+    };
+    CHECK(roles(5) == roles(5));
+    bool differs = false;
+    for (std::uint64_t seed = 6; seed < 16 && !differs; ++seed) differs = roles(seed) != roles(5);
+    CHECK(differs);
+
+    // Two tables set up on different threads don't disturb each other
+    std::vector<RoleId> fromThread;
+    std::thread other([&fromThread, &roles]() { fromThread = roles(5); });
+    std::vector<RoleId> here = roles(5);
+    other.join();
+    CHECK(fromThread == here);
+
+    // A game with a bot replays exactly from its seed (iteration budget)
+    auto botGame = [](std::uint64_t seed) {
+        Game game(seed);
+        for (int i = 0; i < 4; ++i) game.addPlayerWithRandomRole("P" + std::to_string(i));
+        MctsConfig config;
+        config.iterations = 50;
+        MctsBot bot(config);
+        std::vector<std::string> log;
+        for (int turn = 0; turn < 40 && game.winner() == nullptr; ++turn) bot.playTurn(game, log);
+        return std::make_pair(game.state(), game.random());
+    };
+    auto first = botGame(9);
+    auto second = botGame(9);
+    CHECK(first.first == second.first);
+    CHECK(first.second == second.second);
+    CHECK(Game(9).seed() == 9);
+    CHECK(Game(9).clone().random() == Game(9).random()); // A clone continues the same stream
+}
+
+TEST_CASE("Concurrent tables stress") {
+    std::cout << "\n=========== Test concurrent tables ===========\n";
+
+    // Plays one table to the end with random moves, cloning and undoing on the way, and returns its final hash
+    auto playTable = [](std::uint64_t seed) {
+        Game game(seed);
+        game.enableUndo();
+        int players = 2 + static_cast<int>(game.random().below(5));
+        for (int i = 0; i < players; ++i) game.addPlayerWithRandomRole("P" + std::to_string(i));
+        std::vector<std::string> log;
+        for (int turn = 0; turn < 300 && game.winner() == nullptr; ++turn) {
+            Player* current = game.turn();
+            MoveList moves = game.legalActions(current);
+            if (moves.empty()) {
+                game.nextTurn();
+                continue;
+            }
+            const Move& move = moves[game.random().below(static_cast<std::uint32_t>(moves.size()))];
+            if (move.target == NO_SEAT) game.handleTurnWithNoTarget(current, move.action, log);
+            else game.handleTurnWithTarget(current, move.action, game.playerAt(move.target), log);
+
+            // Now and then look ahead on a clone, and take a move back and play it again
+            if (turn % 25 == 0) {
+                Game fork = game.clone();
+                fork.nextTurn();
+            }
+            if (turn % 40 == 0 && game.undo()) {
+                current = game.turn();
+                if (move.target == NO_SEAT) game.handleTurnWithNoTarget(current, move.action, log);
+                else game.handleTurnWithTarget(current, move.action, game.playerAt(move.target), log);
+            }
+            log.clear();
+        }
+        return game.hash();
+    };
+
+    // Thousands of independent tables on many threads at once (run `make tsan` to check this under ThreadSanitizer)
+    const int games = 2000;
+    const int threads = 8;
+    std::vector<std::uint64_t> hashes(games);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&hashes, &playTable, t]() {
+            for (int g = t; g < games; g += threads) hashes[g] = playTable(Rng::streamSeed(77, g));
+        });
+    }
+    for (std::thread& worker : pool) worker.join();
+
+    // Each table ended exactly where it ends when played alone
+    for (int g = 0; g < games; g += 50) {
+        CHECK(hashes[g] == playTable(Rng::streamSeed(77, g)));
+    }
+
+    // Bots and the batch simulator on several threads at once
+    std::vector<SimResult> results(4);
+    pool.clear();
+    for (int t = 0; t < 4; ++t) {
+        pool.emplace_back([&results, t]() {
+            SimConfig config;
+            config.games = 100;
+            config.threads = 2;
+            config.seed = 5;
+            results[t] = runSimulation(config);
+
+            Game game(t);
+            for (int i = 0; i < 3; ++i) game.addPlayerWithRandomRole("P" + std::to_string(i));
+            MctsConfig botConfig;
+            botConfig.iterations = 100;
+            MctsBot bot(botConfig);
+            std::vector<std::string> log;
+            for (int turn = 0; turn < 10 && game.winner() == nullptr; ++turn) bot.playTurn(game, log);
+        });
+    }
+    for (std::thread& worker : pool) worker.join();
+    for (const SimResult& r : results) CHECK(r.totalTurns == results[0].totalTurns);
+}
+
+TEST_CASE("Typed event stream") {
+    std::cout << "\n=========== Test typed event stream ===========\n";
+    Game game;
+    game.addPlayerWithRole("Dexter", "Spy");
+    game.addPlayerWithRole("Debra", "Governor");
+    game.addPlayerWithRole("James", "Merchant");
+    std::vector<Player*> p = game.getPlayers();
+
+    // Off by default - nothing is collected
+    CHECK_FALSE(game.events().isEnabled());
+    game.handleTurnWithNoTarget(p[0], ActionId::Gather);
+    CHECK(game.events().empty());
+
+    // Events carry seats, action, outcome and coin deltas
+    game.events().setEnabled(true);
+    game.handleTurnWithNoTarget(p[1], ActionId::Tax);
+    REQUIRE(game.events().size() == 1);
+    const GameEvent& tax = game.events()[0];
+    CHECK(tax.kind == EventKind::ActionPlayed);
+    CHECK(tax.action == ActionId::Tax);
+    CHECK(tax.actor == 1);
+    CHECK(tax.target == NO_SEAT);
+    CHECK(tax.actorCoins == Rules::GOVERNOR_TAX_GAIN); // Governor tax
+    CHECK(renderEvent(game, tax) == "Debra used tax ");
+
+    game.handleTurnWithTarget(p[2], ActionId::Arrest, p[2]);
+    REQUIRE(game.events().size() == 2);
+    CHECK(game.events()[1].kind == EventKind::ActionFailed);
+    CHECK(game.events()[1].result == ActionResult::SelfTarget);
+    CHECK(renderEvent(game, game.events()[1]) == "Action failed: Cannot perform Arrest on yourself");
+
+    game.handleTurnWithTarget(p[2], ActionId::Arrest, p[1]);
+    const GameEvent& arrest = game.events()[2];
+    CHECK(arrest.kind == EventKind::ActionPlayed);
+    CHECK(arrest.actorCoins == Rules::ARREST_STEAL);
+    CHECK(arrest.targetCoins == -Rules::ARREST_STEAL);
+    CHECK(renderEvent(game, arrest) == "James arrested Debra");
+
+    // The buffer is reused, and the string-log entry points render the same text
+    game.events().clear();
+    CHECK(game.events().empty());
+    game.events().setEnabled(false);
+    std::vector<std::string> log;
+    game.handleTurnWithNoTarget(p[0], ActionId::Gather, log);
+    REQUIRE(log.size() == 1);
+    CHECK(log[0] == "Dexter used gather ");
+    CHECK(game.events().empty()); // Rendering does not leave events behind while they are off
+    game.passTurn(log);
+    CHECK(log.back() == "Debra has no legal move and passes the turn.");
+    game.handleTurnWithTarget(nullptr, ActionId::Arrest, p[0], log);
+    CHECK(log.back() == "Invalid turn: Player or target is null.");
+    CHECK(sizeof(GameEvent) <= 12);
+
+    // Block and passive texts name the action and role of the event, with the amounts the rules charged
+    auto lastText = [](Game& g) { return renderEvent(g, g.events()[g.events().size() - 1]); };
+    auto coins = [](int n) { return std::to_string(n) + " coins"; };
+    Game blocks;
+    setUpGame(blocks);
+    blocks.events().setEnabled(true);
+    std::vector<Player*> b = blocks.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+    CHECK_FALSE(blocks.handleBlockConsequences(ActionId::Bribe, b[5], b[0]));
+    CHECK(lastText(blocks) == "Dexter tried Bribe but didn't have " + coins(Rules::BRIBE_COST) + " to lose.");
+    b[0]->addCoins(Rules::BRIBE_COST);
+    CHECK(blocks.handleBlockConsequences(ActionId::Bribe, b[5], b[0]));
+    CHECK(lastText(blocks) == "Dexter loses " + coins(Rules::BRIBE_COST) + " due to blocked Bribe.");
+    b[0]->addCoins(Rules::COUP_COST);
+    CHECK_FALSE(blocks.handleBlockConsequences(ActionId::Coup, b[2], b[0]));
+    CHECK(lastText(blocks) == "Angel tried to block Coup but lacked " + coins(Rules::BLOCK_COUP_COST) + ".");
+    b[2]->addCoins(Rules::BLOCK_COUP_COST);
+    CHECK(blocks.handleBlockConsequences(ActionId::Coup, b[2], b[0]));
+    CHECK(lastText(blocks) == "Angel blocked Coup action and lost " + coins(Rules::BLOCK_COUP_COST) + ".\n" +
+                              "Dexter's coup attempt got blocked and lost " + coins(Rules::COUP_COST) + ".");
+
+    std::istringstream text("block_penalty Tax 1\nblock_cost Arrest 2\npassive_threshold Baron 0\npassive_gain Baron 2\n");
+    const RuleTable house = parseRules(text);
+    Game custom;
+    setUpGame(custom);
+    custom.setRules(house);
+    custom.events().setEnabled(true);
+    std::vector<Player*> c = custom.getPlayers();
+    CHECK_FALSE(custom.handleBlockConsequences(ActionId::Tax, c[1], c[2]));
+    CHECK(lastText(custom) == "Angel tried Tax but didn't have 1 coins to lose.");
+    c[2]->addCoins(1);
+    CHECK(custom.handleBlockConsequences(ActionId::Tax, c[1], c[2]));
+    CHECK(lastText(custom) == "Angel loses 1 coins due to blocked Tax.");
+    CHECK_FALSE(custom.handleBlockConsequences(ActionId::Arrest, c[0], c[3]));
+    CHECK(lastText(custom) == "Dexter tried to block Arrest but lacked 2 coins.");
+    c[0]->addCoins(2);
+    CHECK(custom.handleBlockConsequences(ActionId::Arrest, c[0], c[3]));
+    CHECK(lastText(custom) == "Dexter blocked Arrest action and lost 2 coins.");
+    custom.handleMerchantPassive(c[3]);
+    CHECK(lastText(custom) == "Joey (Baron) gained 2 passive coins for having 0+ coins.");
+}
+
+TEST_CASE("Binary replay") {
+    std::cout << "\n=========== Test binary replay ===========\n";
+
+    for (std::uint64_t seed = 1; seed <= 20; ++seed) {
+        Game original(seed);
+        for (int i = 0; i < 6; ++i) original.addPlayerWithRandomRole("P" + std::to_string(i));
+        std::unique_ptr<ReplayWriter> writer(new ReplayWriter(original));
+        original.recordTo(writer.get());
+        playRandomGame(original, 300, seed % 2 == 0);
+
+        // Replaying the bytes ends in exactly the same state
+        ReplayReader reader(writer->bytes());
+        CHECK(reader.header().seed == seed);
+        REQUIRE(reader.header().names.size() == 6);
+        CHECK(reader.header().names[3] == "P3");
+        Game copy = gameFromReplay(reader.header());
+        CHECK(replayGame(copy, reader) == static_cast<long>(writer->steps()));
+        CHECK(copy.state() == original.state());
+
+        // A few bytes per step (the header takes 39 bytes here)
+        CHECK(writer->bytes().size() <= 39 + 2 * writer->steps());
+    }
+
+    // Clones never record; failed calls are not recorded
+    Game game(3);
+    game.addPlayerWithRole("Dexter", "Spy");
+    game.addPlayerWithRole("Debra", "Governor");
+    ReplayWriter writer(game);
+    game.recordTo(&writer);
+    Game probe = game.clone();
+    probe.handleTurnWithNoTarget(probe.turn(), ActionId::Gather);
+    CHECK(writer.steps() == 0);
+    CHECK(game.handleTurnWithTarget(game.turn(), ActionId::Arrest, game.playerAt(1)) != ActionResult::Ok);
+    CHECK(writer.steps() == 0);
+    game.handleTurnWithNoTarget(game.turn(), ActionId::Gather);
+    CHECK(writer.steps() == 1);
+
+    // Files round-trip and broken data is refused
+    writer.save("test_replay.bin");
+    std::vector<std::uint8_t> bytes = loadReplay("test_replay.bin");
+    std::remove("test_replay.bin");
+    CHECK(bytes == writer.bytes());
+    std::vector<std::uint8_t> broken(bytes.begin(), bytes.begin() + 3);
+    CHECK_THROWS_AS(ReplayReader{broken}, std::runtime_error);
+    broken = bytes;
+    broken.push_back(0x80); // Truncated varint
+    ReplayReader truncated(broken);
+    ReplayStep step;
+    CHECK(truncated.next(step));
+    CHECK_THROWS_AS(truncated.next(step), std::runtime_error);
+}
+
+TEST_CASE("Replay keyframes") {
+    std::cout << "\n=========== Test replay keyframes ===========\n";
+
+    for (std::uint64_t seed = 1; seed <= 10; ++seed) {
+        Game original(seed);
+        for (int i = 0; i < 6; ++i) original.addPlayerWithRandomRole("P" + std::to_string(i));
+        ReplayWriter plain(original);
+        ReplayWriter keyed(original, 16);
+        Game twin = original.clone();
+        original.recordTo(&plain);
+        twin.recordTo(&keyed);
+        playRandomGame(original, 300, seed % 2 == 0);
+        playRandomGame(twin, 300, seed % 2 == 0);
+        REQUIRE(keyed.steps() == plain.steps());
+        CHECK(keyed.bytes().size() > plain.bytes().size()); // Keyframes cost space
+
+        // Seeking anywhere gives the same table as replaying from the start
+        ReplayReader linear(plain.bytes());
+        ReplayReader seeker(keyed.bytes());
+        Game walked = gameFromReplay(linear.header());
+        Game sought = gameFromReplay(seeker.header());
+        ReplayStep step;
+        for (std::size_t target = 0; target <= plain.steps(); ++target) {
+            if (target > 0) {
+                REQUIRE(linear.next(step));
+                REQUIRE(applyStep(walked, step));
+            }
+            if (target % 7 == 0 || target == plain.steps()) {
+                CHECK(seeker.seek(sought, target) == target);
+                CHECK(sought.state() == walked.state());
+            }
+        }
+        CHECK(seeker.seek(sought, 3) == 3); // Backwards too
+        CHECK(seeker.seek(sought, plain.steps() + 100) == plain.steps()); // Past the end stops at the end
+        CHECK(sought.state() == original.state());
+
+        // Keyframes are skipped by a plain replay
+        seeker.rewind();
+        Game full = gameFromReplay(seeker.header());
+        CHECK(replayGame(full, seeker) == static_cast<long>(keyed.steps()));
+        CHECK(full.state() == original.state());
+    }
+}
+
+TEST_CASE("Replays under a rules file") {
+    std::cout << "\n=========== Test replays under a rules file ===========\n";
+    std::istringstream text("passive_threshold all 0\npassive_gain Baron 2\npassive_gain Merchant 3\ncost Coup 6\n");
+    const RuleTable house = parseRules(text, "house.rules");
+
+    for (std::uint64_t seed = 1; seed <= 10; ++seed) {
+        Game original(seed);
+        original.setRules(house); // Before the writer - the header stores the rules' fingerprint
+        for (int i = 0; i < 6; ++i) original.addPlayerWithRandomRole("P" + std::to_string(i));
+        ReplayWriter keyed(original, 16);
+        original.recordTo(&keyed);
+        playRandomGame(original, 300, seed % 2 == 0);
+
+        // The same table replays it, passive gains of any size included
+        ReplayReader reader(keyed.bytes());
+        CHECK(reader.header().rulesFingerprint == fingerprintRules(house));
+        Game copy = gameFromReplay(reader.header(), &house);
+        CHECK(replayGame(copy, reader) == static_cast<long>(keyed.steps()));
+        CHECK(copy.state() == original.state());
+
+        // Other rules are refused before the first step
+        CHECK_THROWS_AS(gameFromReplay(reader.header()), std::runtime_error);
+
+        // Seeking from before the first keyframe keeps the rules of the game it is given
+        Game sought = gameFromReplay(reader.header(), &house);
+        CHECK(reader.seek(sought, keyed.steps()) == keyed.steps());
+        CHECK(reader.seek(sought, 1) == 1);
+        CHECK(&sought.rules() == &house);
+        CHECK(reader.seek(sought, keyed.steps()) == keyed.steps());
+        CHECK(sought.state() == original.state());
+    }
+
+    // Version 2 replays (no fingerprint) still load, with whatever rules the caller gives
+    Game game(5);
+    game.addPlayerWithRole("Dexter", "Spy");
+    game.addPlayerWithRole("Debra", "Governor");
+    ReplayWriter writer(game);
+    game.recordTo(&writer);
+    game.handleTurnWithNoTarget(game.turn(), ActionId::Gather);
+    std::vector<std::uint8_t> old = writer.bytes();
+    old[4] = 2;
+    old.erase(old.begin() + 6, old.begin() + 14); // The seed 5 is one varint byte, the fingerprint follows it
+    ReplayReader reader(old);
+    CHECK(reader.header().rulesFingerprint == 0);
+    CHECK(reader.header().names[1] == "Debra");
+    Game replayed = gameFromReplay(reader.header(), &house);
+    CHECK(replayGame(replayed, reader) == 1);
+}
+
+TEST_CASE("Memory-mapped replay archive") {
+    std::cout << "\n=========== Test replay archive ===========\n";
+
+    // 100 recorded games, a checkpoint every 8 games
+    std::vector<std::vector<std::uint8_t>> replays;
+    long totalSteps = 0;
+    {
+        ArchiveWriter archive("test_archive.bin", 8);
+        for (std::uint64_t seed = 1; seed <= 100; ++seed) {
+            Game game(seed);
+            for (int i = 0; i < 4; ++i) game.addPlayerWithRandomRole("P" + std::to_string(i));
+            ReplayWriter writer(game, seed % 3 == 0 ? 8 : 0); // Some games carry keyframes
+            game.recordTo(&writer);
+            playRandomGame(game, 200, false);
+            archive.add(writer);
+            replays.push_back(writer.bytes());
+            totalSteps += static_cast<long>(writer.steps());
+        }
+        CHECK(archive.games() == 100);
+    } // The destructor writes the footer
+
+    ReplayArchive archive("test_archive.bin");
+    CHECK(archive.games() == 100);
+
+    // Games come back byte for byte, and the in-place steps match the reader's
+    std::size_t index = 0;
+    for (const ReplayView& game : archive.all()) {
+        REQUIRE(index < replays.size());
+        CHECK(std::vector<std::uint8_t>(game.data, game.data + game.size) == replays[index]);
+        ReplayReader reader(game.data, game.size);
+        ReplayStep expected;
+        for (const ReplayStep& step : game.steps()) {
+            REQUIRE(reader.next(expected));
+            CHECK((step.kind == expected.kind && step.action == expected.action && step.actor == expected.actor && step.target == expected.target));
+        }
+        CHECK_FALSE(reader.next(expected));
+        ++index;
+    }
+    CHECK(index == 100);
+
+    // Disjoint partitions cover every game, and threads can scan them at once
+    for (std::size_t parts : {1, 3, 4, 50}) {
+        std::vector<ArchiveRange> ranges = archive.partition(parts);
+        CHECK(ranges.size() <= parts);
+        std::vector<long> steps(ranges.size()), games(ranges.size());
+        std::vector<std::thread> pool;
+        for (std::size_t r = 0; r < ranges.size(); ++r) {
+            pool.emplace_back([&ranges, &steps, &games, r]() {
+                for (const ReplayView& game : ranges[r]) {
+                    ++games[r];
+                    for (auto it = game.steps().begin(); it != game.steps().end(); ++it) ++steps[r];
+                }
+            });
+        }
+        for (std::thread& worker : pool) worker.join();
+        long gameSum = 0, stepSum = 0;
+        for (std::size_t r = 0; r < ranges.size(); ++r) {
+            gameSum += games[r];
+            stepSum += steps[r];
+        }
+        CHECK(gameSum == 100);
+        CHECK(stepSum == totalSteps);
+    }
+    if (archive.partition(4).size() > 1) CHECK(archive.partition(4)[0].bytes() < archive.all().bytes());
+
+    // An archive without its footer is still readable
+    std::vector<std::uint8_t> unfinished = {'C', 'P', 'R', 'A', 1};
+    for (int g = 0; g < 3; ++g) {
+        putVarint(unfinished, replays[g].size());
+        unfinished.insert(unfinished.end(), replays[g].begin(), replays[g].end());
+    }
+    std::ofstream("test_archive.bin", std::ios::binary).write(reinterpret_cast<const char*>(unfinished.data()), static_cast<std::streamsize>(unfinished.size()));
+    {
+        ReplayArchive partial("test_archive.bin");
+        CHECK(partial.games() == 3);
+        CHECK(std::distance(partial.all().begin(), partial.all().end()) == 3);
+    }
+
+    // A crash in the middle of a game leaves it out - the reader stops at the last whole game
+    const std::size_t whole = unfinished.size();
+    putVarint(unfinished, replays[3].size());
+    unfinished.insert(unfinished.end(), replays[3].begin(), replays[3].begin() + replays[3].size() / 2);
+    for (std::size_t cut : {whole + 1, unfinished.size()}) {
+        std::ofstream("test_archive.bin", std::ios::binary).write(reinterpret_cast<const char*>(unfinished.data()), static_cast<std::streamsize>(cut));
+        ReplayArchive crashed("test_archive.bin");
+        CHECK(crashed.games() == 3);
+        CHECK(crashed.all().bytes() == whole - 5);
+        int read = 0;
+        for (ReplayView view : crashed.all()) CHECK(view.size == replays[read++].size());
+        CHECK(read == 3);
+    }
+    std::remove("test_archive.bin");
+    CHECK_THROWS_AS(ReplayArchive("test_archive.bin"), std::runtime_error);
+}
+
+TEST_CASE("Players live inside their game") {
+    std::cout << "\n=========== Test in-place players ===========\n";
+    Game game;
+    setUpGame(game);
+
+    // Every player is built in the game object itself
+    const char* begin = reinterpret_cast<const char*>(&game);
+    const char* end = begin + sizeof(Game);
+    for (std::size_t seat = 0; seat < 6; ++seat) {
+        const char* p = reinterpret_cast<const char*>(game.playerAt(seat));
+        CHECK((p >= begin && p < end));
+    }
+    CHECK(game.playerAt(3)->roleId() == RoleId::Baron);
+    CHECK(dynamic_cast<Baron*>(game.playerAt(3)) != nullptr);
+
+    // Long names survive copies and moves
+    Game named;
+    named.addPlayerWithRole("A player with a name longer than the small string buffer", RoleId::Spy);
+    named.addPlayerWithRole("B", RoleId::Judge);
+    Game copy = named;
+    Game moved = std::move(named);
+    CHECK(copy.playerAt(0)->getName() == "A player with a name longer than the small string buffer");
+    CHECK(moved.playerAt(0)->getName() == copy.playerAt(0)->getName());
+    moved = std::move(copy);
+    CHECK(moved.playerAt(1)->getName() == "B");
+    CHECK(moved.playerAt(1)->roleId() == RoleId::Judge);
+}
+
+TEST_CASE("Role specials through the base player") {
+    std::cout << "\n=========== Test role specials ===========\n";
+    Game game;
+    setUpGame(game);
+    std::vector<Player*> p = game.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+
+    // Every player answers the specials - other roles are refused without a cast
+    CHECK(p[0]->tryInvest() == ActionResult::WrongRole);
+    CHECK(p[0]->tryPreventCoup(*p[1]) == ActionResult::WrongRole);
+    CHECK(p[0]->tryTax() == ActionResult::Ok);
+    CHECK(p[0]->coins() == Rules::TAX_GAIN);
+    game.nextTurn(); // Debra (Governor)
+    CHECK(p[1]->tryTax() == ActionResult::Ok); // Governor tax without a virtual call
+    CHECK(p[1]->coins() == Rules::GOVERNOR_TAX_GAIN);
+
+    p[3]->addCoins(Rules::INVEST_COST);
+    CHECK(p[2]->tryPreventCoup(*p[3]) == ActionResult::NotEnoughCoins);
+    game.nextTurn(); // Angel (General)
+    game.nextTurn(); // Joey (Baron)
+    CHECK(p[3]->tryInvest() == ActionResult::Ok);
+    CHECK(p[3]->coins() == Rules::INVEST_RETURN);
+}
+
+TEST_CASE("Active player view") {
+    std::cout << "\n=========== Test active player view ===========\n";
+    Game game;
+    setUpGame(game);
+    game.enableUndo();
+    CHECK(game.activeCount() == 6);
+    CHECK(game.activePlayers().size() == 6);
+    CHECK(std::vector<Player*>(game.activePlayers().begin(), game.activePlayers().end()) == game.getPlayers());
+
+    // The view skips eliminated seats and follows the table without being rebuilt
+    ActivePlayers view = game.activePlayers();
+    Player* angel = game.playerAt(2);
+    game.playerAt(0)->addCoins(Rules::COUP_COST);
+    CHECK(game.handleTurnWithTarget(game.turn(), ActionId::Coup, angel) == ActionResult::Ok);
+    CHECK(game.activeCount() == 6); // On coup trial until his turn comes
+    game.checkElimination(); // Debra's turn - nothing to do
+    game.nextTurn();
+    game.checkElimination(); // Angel's coup was not blocked
+    CHECK(!angel->isActive());
+    CHECK(view.size() == 5);
+    CHECK(game.activeCount() == 5);
+    std::vector<std::string> names;
+    for (Player* p : view) names.push_back(p->getName());
+    CHECK(names == game.players());
+    CHECK(std::find(names.begin(), names.end(), "Angel") == names.end());
+
+    // Undo and loadState keep the count
+    while (game.undo()) {}
+    CHECK(game.activeCount() == 6);
+    GameState out = game.state();
+    out.flags[4] = 0;
+    out.active_seats = maskOf({0, 1, 2, 3, 4, 5}); // A wrong mask from outside is recomputed
+    game.loadState(out);
+    CHECK(game.activeCount() == 5);
+    CHECK(game.getPlayers().size() == 5);
+
+    // Down to one player: the view has a single winner
+    for (std::uint8_t seat = 1; seat < 6; ++seat) game.playerAt(seat)->eliminate();
+    CHECK(game.activeCount() == 1);
+    CHECK(*game.activePlayers().begin() == game.winner());
+    CHECK(game.winner() == game.playerAt(0));
+}
+
+TEST_CASE("Active and coup-trial seat masks") {
+    std::cout << "\n=========== Test seat masks ===========\n";
+    const SeatMask seats = maskOf({0, 2, 3, 5});
+    CHECK(seatCount(seats) == 4);
+    CHECK(firstSeat(SeatMask{}) == NO_SEAT);
+    CHECK(nextSeat(seats, 0) == 2);
+    CHECK(nextSeat(seats, 3) == 5);
+    CHECK(nextSeat(seats, 5) == 0); // Wraps around
+    CHECK(seatAfter(seats, 5) == NO_SEAT);
+    CHECK(nextSeat(maskOf({0}), 0) == 0); // Alone at the table
+
+    Game game;
+    setUpGame(game);
+    game.enableUndo();
+    CHECK(game.state().active_seats == maskOf({0, 1, 2, 3, 4, 5}));
+    CHECK(seatCount(game.state().trial_seats) == 0);
+
+    // Eliminated seats are skipped when the turn moves on
+    game.playerAt(1)->eliminate();
+    game.playerAt(2)->eliminate();
+    game.nextTurn();
+    CHECK(game.turn() == game.playerAt(3));
+
+    // Every player on trial is eliminated by a single turn() call
+    game.playerAt(3)->deactivate();
+    game.playerAt(4)->deactivate();
+    game.playerAt(5)->deactivate();
+    CHECK(game.state().trial_seats == maskOf({3, 4, 5}));
+    CHECK(game.turn() == game.playerAt(0));
+    CHECK(seatCount(game.state().trial_seats) == 0);
+    CHECK(game.winner() == game.playerAt(0));
+
+    // The masks are journaled with the flags
+    while (game.undo()) {}
+    CHECK(game.state().active_seats == maskOf({0, 1, 2, 3, 4, 5}));
+    CHECK(game.activeCount() == 6);
+    CHECK(seatCount(game.state().trial_seats) == 0);
+    CHECK(game.winner() == nullptr);
+}
+
+TEST_CASE("Recently arrested seat") {
+    std::cout << "\n=========== Test recently arrested seat ===========\n";
+    Game game;
+    setUpGame(game);
+    game.enableUndo();
+    std::vector<Player*> p = game.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+    for (Player* player : p) player->addCoins(3);
+
+    // One seat carries the cooldown - a new arrest moves it, nobody else has to be cleared
+    CHECK(game.handleTurnWithTarget(p[0], ActionId::Arrest, p[1]) == ActionResult::Ok); // Dexter arrests Debra
+    CHECK(game.state().last_arrested == 1);
+    CHECK(game.handleTurnWithNoTarget(p[1], ActionId::Gather) == ActionResult::Ok);
+    CHECK(game.handleTurnWithTarget(p[2], ActionId::Arrest, p[1]) == ActionResult::RecentlyArrested); // Still Debra's cooldown
+    CHECK(game.handleTurnWithTarget(p[2], ActionId::Arrest, p[3]) == ActionResult::Ok); // Angel arrests Joey
+    CHECK(game.state().last_arrested == 3);
+    CHECK(game.handleTurnWithTarget(p[3], ActionId::Arrest, p[1]) == ActionResult::Ok); // Debra can be arrested again
+    CHECK(game.state().last_arrested == 1);
+
+    // Undo puts the mark back where it was
+    CHECK(game.undo());
+    CHECK(game.state().last_arrested == 3);
+    CHECK(game.undo());
+    CHECK(game.state().last_arrested == 1);
+    CHECK(game.hash() == zobrist::compute(game.state()));
+}
+
+TEST_CASE("Player flags read from the packed table") {
+    std::cout << "\n=========== Test packed player flags ===========\n";
+    Game game;
+    setUpGame(game);
+    std::vector<Player*> p = game.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+    p[0]->addCoins(Rules::SANCTION_COST);
+
+    // Every getter is a bit of the seat's flag byte
+    CHECK(p[0]->trySanction(*p[1]) == ActionResult::Ok);
+    CHECK(p[0]->tryBlockArrest(*p[1]) == ActionResult::Ok);
+    CHECK(p[1]->onSanctioned());
+    CHECK(p[1]->onArrestedBlocked());
+    CHECK_FALSE(p[1]->onTaxBlocked());
+    CHECK(game.state().flags[1] == (FLAG_ACTIVE | FLAG_SANCTIONED | FLAG_ARREST_BLOCKED));
+
+    // One mask clears every one-turn flag
+    p[1]->resetTurnFlags();
+    CHECK(game.state().flags[1] == FLAG_ACTIVE);
+    CHECK_FALSE(p[1]->onSanctioned());
+    CHECK_FALSE(p[1]->onArrestedBlocked());
+
+    // A copy's players read the copy's table
+    Game copy = game;
+    copy.playerAt(2)->deactivate();
+    CHECK(copy.playerAt(2)->onCoupTrial());
+    CHECK_FALSE(p[2]->onCoupTrial());
+    CHECK(copy.playerAt(0)->coins() == p[0]->coins());
+}
+
+TEST_CASE("Tables of every supported size") {
+    std::cout << "\n=========== Test full table (" << MAX_PLAYERS << " seats) ===========\n";
+    Game game;
+    for (std::size_t seat = 0; seat < MAX_PLAYERS; ++seat) game.addPlayerWithRole("P" + std::to_string(seat + 1), "Spy");
+    CHECK_THROWS_WITH(game.addPlayerWithRole("One too many", "Spy"), ("Maximum " + std::to_string(MAX_PLAYERS) + " players allowed").c_str());
+    game.enableUndo();
+    CHECK(game.activeCount() == MAX_PLAYERS);
+
+    // Knock out every seat but the first and the last - the turn jumps straight across the gap
+    const Seat last = static_cast<Seat>(MAX_PLAYERS - 1);
+    for (Seat seat = 1; seat < last; ++seat) game.playerAt(seat)->eliminate();
+    CHECK(game.activeCount() == 2);
+    CHECK(seatAfter(game.state().active_seats, 0) == last);
+    game.nextTurn();
+    CHECK(game.turn() == game.playerAt(last));
+    game.nextTurn();
+    CHECK(game.turn() == game.playerAt(0)); // Wraps around
+
+    // The view walks only the two players left
+    std::vector<Player*> left(game.activePlayers().begin(), game.activePlayers().end());
+    CHECK(left == std::vector<Player*>{game.playerAt(0), game.playerAt(last)});
+
+    // Last seat on trial: eliminated on his turn, the first seat wins
+    game.playerAt(last)->deactivate();
+    game.nextTurn();
+    CHECK(game.turn() == game.playerAt(0));
+    CHECK(game.winner() == game.playerAt(0));
+
+    // Everything is undone through the masks too
+    while (game.undo()) {}
+    CHECK(game.activeCount() == MAX_PLAYERS);
+    CHECK(seatCount(game.state().trial_seats) == 0);
+    CHECK(game.state().active_seats == seatsWith(game.state(), FLAG_ACTIVE));
+    CHECK(game.hash() == zobrist::compute(game.state()));
+
+    // Every seat but the first on trial: one turn() drains the whole run without nesting a frame per seat
+    for (Seat seat = 1; seat <= last; ++seat) game.playerAt(seat)->deactivate();
+    game.nextTurn();
+    CHECK(game.state().current_turn == 1);
+    CHECK(game.turn() == game.playerAt(0));
+    CHECK(game.state().last_turn == last);
+    CHECK(seatCount(game.state().trial_seats) == 0);
+    CHECK(game.winner() == game.playerAt(0));
+    while (game.undo()) {}
+    CHECK(game.activeCount() == MAX_PLAYERS);
+    CHECK(game.hash() == zobrist::compute(game.state()));
+}
+
+// Plays the rules of variant P through the engine on a game set to `rules` (the variant's table)
+template <typename P>
+void checkRuleVariant(const RuleTable& rules) {
+    std::cout << "Variant " << P::NAME << "\n";
+    std::vector<std::string> log;
+    Game game;
+    game.setRules(rules);
+    setUpGame(game);
+    std::vector<Player*> p = game.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+    CHECK(game.rules() == rules);
+
+    // Gains of the plain actions and the Baron's investment
+    game.handleTurnWithNoTarget(p[0], ActionId::Tax, log);
+    CHECK(p[0]->coins() == P::TAX_GAIN);
+    game.handleTurnWithNoTarget(p[1], ActionId::Tax, log);
+    CHECK(p[1]->coins() == P::GOVERNOR_TAX_GAIN);
+    game.handleTurnWithNoTarget(p[2], ActionId::Gather, log);
+    CHECK(p[2]->coins() == P::GATHER_GAIN);
+    p[3]->addCoins(P::INVEST_COST);
+    game.handleTurnWithNoTarget(p[3], ActionId::Invest, log);
+    CHECK(p[3]->coins() == P::INVEST_RETURN);
+
+    // The Merchant's passive coin
+    p[4]->addCoins(P::MERCHANT_PASSIVE_COINS);
+    game.handleMerchantPassive(p[4]);
+    CHECK(p[4]->coins() == P::MERCHANT_PASSIVE_COINS + P::MERCHANT_PASSIVE_GAIN);
+    game.handleTurnWithNoTarget(p[4], ActionId::Gather, log);
+    game.handleTurnWithNoTarget(p[5], ActionId::Gather, log);
+
+    // Sanction prices: the Judge surcharge and the Baron's compensation
+    p[0]->addCoins(P::SANCTION_COST - p[0]->coins());
+    MoveList moves = game.legalActions(p[0]);
+    CHECK(moves.contains(ActionId::Sanction, 3));
+    CHECK(moves.contains(ActionId::Sanction, 5) == (P::JUDGE_SANCTION_SURCHARGE == 0));
+    game.handleTurnWithTarget(p[0], ActionId::Sanction, p[3], log);
+    CHECK(p[0]->coins() == 0);
+    CHECK(p[3]->coins() == P::INVEST_RETURN + P::BARON_SANCTION_REFUND);
+
+    // Forced coup threshold and the coup price
+    game.handleTurnWithNoTarget(p[1], ActionId::Gather, log);
+    game.handleTurnWithNoTarget(p[2], ActionId::Gather, log);
+    CHECK(game.turn() == p[3]);
+    p[3]->addCoins(P::FORCED_COUP_COINS - 1 - p[3]->coins());
+    CHECK(game.legalActions(p[3]).contains(ActionId::Invest));
+    p[3]->addCoins(1);
+    moves = game.legalActions(p[3]);
+    CHECK(moves.size() == 5); // A coup on every other seat and nothing else
+    for (const Move& m : moves) CHECK(m.action == ActionId::Coup);
+    game.handleTurnWithTarget(p[3], ActionId::Coup, p[5], log);
+    CHECK(p[3]->coins() == P::FORCED_COUP_COINS - P::COUP_COST);
+    CHECK(p[5]->onCoupTrial());
+
+    // A copy keeps its variant
+    Game copy = game;
+    CHECK(copy.rules() == rules);
+}
+
+// Runs checkRuleVariant for every variant of RuleVariants
+template <std::size_t... I>
+void checkRuleVariants(std::index_sequence<I...>) {
+    (checkRuleVariant<std::tuple_element_t<I, RuleVariants>>(variantRules(I)), ...);
+}
+
+TEST_CASE("Rule policy") {
+    std::cout << "\n=========== Test rule policy (" << Rules::NAME << ") ===========\n";
+    // A variant only overrides what it changes
+    static_assert(QuickCoupRules::COUP_COST < StandardRules::COUP_COST, "Quick coups are cheaper");
+    static_assert(QuickCoupRules::FORCED_COUP_COINS < StandardRules::FORCED_COUP_COINS, "Quick coups are forced earlier");
+    static_assert(QuickCoupRules::BRIBE_COST == StandardRules::BRIBE_COST, "Everything else is standard");
+
+    // The default rule table agrees with the built-in policy
+    const RuleTable& builtIn = defaultRules();
+    for (std::size_t a = 0; a < ACTION_COUNT; ++a) {
+        const ActionId action = static_cast<ActionId>(a);
+        CHECK(builtIn.cost[a] == PolicyRules<Rules>::cost(action));
+        CHECK(builtIn.requiredRole(action) == Rules::requiredRole(action));
+        CHECK(builtIn.blockedBy[a] == Rules::blockedBy(action));
+    }
+
+    // Every variant is compiled into this build, and the built-in one comes first
+    CHECK(defaultRules() == variantRules(0));
+    CHECK(std::string(ruleVariantName(0)) == Rules::NAME);
+    std::size_t variant = RULE_VARIANT_COUNT;
+    CHECK(parseRuleVariant("QuickCoupRules", variant));
+    CHECK(std::string(ruleVariantName(variant)) == "QuickCoupRules");
+    CHECK(variantOf(variantRules(variant)) == variant);
+    CHECK_FALSE(parseRuleVariant("NoSuchRules", variant));
+    CHECK(variantRules(variant).cost[static_cast<std::size_t>(ActionId::Coup)] == QuickCoupRules::COUP_COST);
+    checkRuleVariants(std::make_index_sequence<RULE_VARIANT_COUNT>());
+}
+
+TEST_CASE("Rules file") {
+    std::cout << "\n=========== Test rules file ===========\n";
+    // The shipped file spells out the built-in rules (of a standard build)
+    if (std::string(Rules::NAME) == "StandardRules") CHECK(loadRules(std::string(COUP_SOURCE_DIR) + "/Rules/standard.rules") == defaultRules());
+    std::istringstream empty("# only a comment\n\n");
+    CHECK(parseRules(empty) == defaultRules());
+
+    std::istringstream text(
+        "cost Coup 5          # cheaper coups\n"
+        "forced_coup 8\n"
+        "block Tax Spy\n"
+        "tax all 1\n"
+        "passive_threshold Baron 0\n"
+        "passive_gain Baron 2\n"
+        "passive_gain Merchant 0\n");
+    const RuleTable house = parseRules(text);
+    CHECK(house.cost[static_cast<std::size_t>(ActionId::Coup)] == 5);
+    CHECK(house.blockedBy[static_cast<std::size_t>(ActionId::Tax)] == RoleId::Spy);
+    CHECK(house.mayUse(RoleId::Spy, ActionId::BlockTax));
+    CHECK_FALSE(house.mayUse(RoleId::Governor, ActionId::BlockTax));
+    CHECK(house.requiredRole(ActionId::BlockTax) == RoleId::Spy);
+    CHECK(house.taxGain[static_cast<std::size_t>(RoleId::Governor)] == 1);
+
+    Game game;
+    setUpGame(game);
+    game.setRules(house);
+    std::vector<Player*> p = game.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+
+    // The Spy blocks tax now, the Governor doesn't
+    MoveList moves = game.legalActions(p[0]);
+    CHECK(moves.contains(ActionId::BlockTax, 1));
+    CHECK(moves.contains(ActionId::BlockArrest, 1));
+    CHECK(p[1]->tryBlockTax(*p[0]) == ActionResult::WrongRole);
+    CHECK(p[0]->tryBlockTax(*p[1]) == ActionResult::Ok);
+    CHECK(resultMessage(ActionResult::WrongRole, ActionId::BlockTax, *p[1], p[0]) == "BlockTax action only permitted to Spy");
+
+    // Passive coins move from the Merchant to the Baron, and the forced coup comes earlier
+    game.handleMerchantPassive(p[3]);
+    CHECK(p[3]->coins() == 2);
+    p[4]->addCoins(5);
+    game.handleMerchantPassive(p[4]);
+    CHECK(p[4]->coins() == 5);
+    p[0]->addCoins(8);
+    moves = game.legalActions(p[0]);
+    CHECK(moves.size() == 5);
+    for (const Move& m : moves) CHECK(m.action == ActionId::Coup);
+    std::vector<std::string> log;
+    game.handleTurnWithTarget(p[0], ActionId::Coup, p[5], log);
+    CHECK(p[0]->coins() == 3);
+
+    // Copies play by the same table
+    Game copy = game;
+    CHECK(&copy.rules() == &house);
+    CHECK(&Game().rules() == &defaultRules());
+
+    // Bad lines name the line
+    std::istringstream unknown("gather 1\nbogus Coup 3\n");
+    CHECK_THROWS_WITH_AS(parseRules(unknown, "house.rules"), "house.rules:2: unknown setting 'bogus'", std::invalid_argument);
+    std::istringstream badAction("cost Fly 3\n");
+    CHECK_THROWS_WITH_AS(parseRules(badAction), "rules:1: unknown action 'Fly'", std::invalid_argument);
+    std::istringstream badAmount("cost Coup -2\n");
+    CHECK_THROWS_AS(parseRules(badAmount), std::invalid_argument);
+    std::istringstream unblockable("block Gather Judge\n");
+    CHECK_THROWS_AS(parseRules(unblockable), std::invalid_argument);
+    CHECK_THROWS_AS(loadRules("no_such_file.rules"), std::runtime_error);
+
+    // A forced coup nobody can pay for, or that some roles can't play, is refused
+    std::istringstream cheapForced("cost Coup 9\nforced_coup 8\n");
+    CHECK_THROWS_WITH_AS(parseRules(cheapForced, "house.rules"), "house.rules: forced_coup 8 is below the cost of a Coup (9)", std::invalid_argument);
+    std::istringstream judgesCoup("role Coup Judge\n");
+    CHECK_THROWS_AS(parseRules(judgesCoup), std::invalid_argument);
+    std::istringstream evenForced("cost Coup 8\nforced_coup 8\n");
+    CHECK_NOTHROW(parseRules(evenForced));
+}
+
+TEST_CASE("Forced coup the player can't play") {
+    std::cout << "\n=========== Test unplayable forced coup ===========\n";
+    // Tables built in code skip the file checks - the engine keeps the normal moves instead of leaving none
+    RuleTable early = defaultRules();
+    early.forcedCoupCoins = 1; // Forced long before a Coup is affordable
+    Game game;
+    setUpGame(game);
+    game.setRules(early);
+    std::vector<Player*> p = game.getPlayers(); // Spy, Governor, General, Baron, Merchant, Judge
+    p[0]->addCoins(Rules::COUP_COST - 1);
+    CHECK_FALSE(p[0]->mustCoup());
+    MoveList moves = game.legalActions(p[0]);
+    CHECK(moves.contains(ActionId::Gather));
+    CHECK_FALSE(moves.contains(ActionId::Coup, 1));
+    for (int i = 0; i < 50; ++i) CHECK(game.randomLegalAction(p[0], game.random()).action != ActionId::Count);
+    CHECK(game.handleTurnWithNoTarget(p[0], ActionId::Gather) == ActionResult::Ok);
+
+    // Once the Coup is affordable it is forced again
+    p[1]->addCoins(Rules::COUP_COST);
+    CHECK(p[1]->mustCoup());
+    CHECK(p[1]->tryGather() == ActionResult::MustCoup);
+    for (const Move& m : game.legalActions(p[1])) CHECK(m.action == ActionId::Coup);
+
+    // A role that may not Coup is never forced to
+    RuleTable judgesOnly = defaultRules();
+    for (std::size_t r = 0; r < ROLE_COUNT; ++r) {
+        if (static_cast<RoleId>(r) != RoleId::Judge) judgesOnly.allowedActions[r] &= ~(1u << static_cast<unsigned>(ActionId::Coup));
+    }
+    Game rich;
+    setUpGame(rich);
+    rich.setRules(judgesOnly);
+    std::vector<Player*> r = rich.getPlayers();
+    r[0]->addCoins(Rules::FORCED_COUP_COINS);
+    CHECK_FALSE(r[0]->mustCoup());
+    CHECK(rich.legalActions(r[0]).contains(ActionId::Gather));
+    CHECK(rich.handleTurnWithNoTarget(r[0], ActionId::Tax) == ActionResult::Ok);
+    r[5]->addCoins(Rules::FORCED_COUP_COINS);
+    CHECK(r[5]->mustCoup());
+}